@@ -38,6 +38,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
+#include <migraphx/batch_queue.hpp>
 #include <algorithm>
 #include <cstdarg>
 namespace migraphx {
@@ -139,6 +140,20 @@ void set_exhaustive_tune_flag(compile_options& options, bool value)
     options.exhaustive_tune = value;
 }
 
+void set_max_batch(batch_queue_options& options, size_t value) { options.max_batch = value; }
+
+void set_timeout(batch_queue_options& options, size_t microseconds)
+{
+    options.timeout = std::chrono::microseconds{microseconds};
+}
+
+bool is_ready(const batch_result& result)
+{
+    return result.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+std::vector<argument> get_result(const batch_result& result) { return result.get(); }
+
 void set_file_format(file_options& options, const char* format) { options.format = format; }
 
 void set_default_dim_value(onnx_options& options, size_t value)
@@ -596,6 +611,39 @@ struct migraphx_program
     migraphx::program object;
 };
 
+extern "C" struct migraphx_batch_queue_options;
+struct migraphx_batch_queue_options
+{
+    template <class... Ts>
+    migraphx_batch_queue_options(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::batch_queue_options object;
+};
+
+extern "C" struct migraphx_batch_result;
+struct migraphx_batch_result
+{
+    template <class... Ts>
+    migraphx_batch_result(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::batch_result object;
+};
+
+extern "C" struct migraphx_batch_queue;
+struct migraphx_batch_queue
+{
+    template <class... Ts>
+    migraphx_batch_queue(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::batch_queue object;
+};
+
 extern "C" struct migraphx_operation;
 struct migraphx_operation
 {
@@ -1744,6 +1792,145 @@ migraphx_program_experimental_get_context(migraphx_context_t* out, const_migraph
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_batch_queue_options_destroy(migraphx_batch_queue_options_t batch_queue_options)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((batch_queue_options)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_batch_queue_options_assign_to(migraphx_batch_queue_options_t output,
+                                       const_migraphx_batch_queue_options_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_batch_queue_options_create(migraphx_batch_queue_options_t* batch_queue_options)
+{
+    auto api_error_result = migraphx::try_([&] {
+        *batch_queue_options =
+            object_cast<migraphx_batch_queue_options_t>(allocate<migraphx::batch_queue_options>());
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_batch_queue_options_set_max_batch(migraphx_batch_queue_options_t batch_queue_options,
+                                           size_t value)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(batch_queue_options == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter batch_queue_options: Null pointer");
+        migraphx::set_max_batch((batch_queue_options->object), (value));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_batch_queue_options_set_timeout(migraphx_batch_queue_options_t batch_queue_options,
+                                         size_t microseconds)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(batch_queue_options == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param,
+                           "Bad parameter batch_queue_options: Null pointer");
+        migraphx::set_timeout((batch_queue_options->object), (microseconds));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_result_destroy(migraphx_batch_result_t batch_result)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((batch_result)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_result_assign_to(migraphx_batch_result_t output,
+                                                           const_migraphx_batch_result_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_result_ready(bool* out,
+                                                       const_migraphx_batch_result_t batch_result)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(batch_result == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter batch_result: Null pointer");
+        *out = migraphx::is_ready((batch_result->object));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_result_get(migraphx_arguments_t* out,
+                                                     const_migraphx_batch_result_t batch_result)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(batch_result == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter batch_result: Null pointer");
+        *out = allocate<migraphx_arguments_t>(migraphx::get_result((batch_result->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_queue_destroy(migraphx_batch_queue_t batch_queue)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((batch_queue)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_queue_assign_to(migraphx_batch_queue_t output,
+                                                          const_migraphx_batch_queue_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_queue_create(migraphx_batch_queue_t* batch_queue,
+                                                       migraphx_program_t p,
+                                                       migraphx_batch_queue_options_t options)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(p == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter p: Null pointer");
+        if(options == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter options: Null pointer");
+        *batch_queue = object_cast<migraphx_batch_queue_t>(
+            allocate<migraphx::batch_queue>((p->object), (options->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_queue_submit(migraphx_batch_result_t* out,
+                                                       const_migraphx_batch_queue_t batch_queue,
+                                                       migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(batch_queue == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter batch_queue: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_batch_result_t>((batch_queue->object).submit((params->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_batch_queue_max_batch(size_t* out,
+                                                          const_migraphx_batch_queue_t batch_queue)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(batch_queue == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter batch_queue: Null pointer");
+        *out = (batch_queue->object).max_batch();
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_operation_destroy(migraphx_operation_t operation)
 {
     auto api_error_result = migraphx::try_([&] { destroy((operation)); });
@@ -114,6 +114,15 @@ typedef const struct migraphx_module* const_migraphx_module_t;
 typedef struct migraphx_program* migraphx_program_t;
 typedef const struct migraphx_program* const_migraphx_program_t;
 
+typedef struct migraphx_batch_queue_options* migraphx_batch_queue_options_t;
+typedef const struct migraphx_batch_queue_options* const_migraphx_batch_queue_options_t;
+
+typedef struct migraphx_batch_result* migraphx_batch_result_t;
+typedef const struct migraphx_batch_result* const_migraphx_batch_result_t;
+
+typedef struct migraphx_batch_queue* migraphx_batch_queue_t;
+typedef const struct migraphx_batch_queue* const_migraphx_batch_queue_t;
+
 typedef struct migraphx_operation* migraphx_operation_t;
 typedef const struct migraphx_operation* const_migraphx_operation_t;
 
@@ -467,6 +476,51 @@ MIGRAPHX_C_EXPORT migraphx_status migraphx_program_equal(bool* out,
 MIGRAPHX_C_EXPORT migraphx_status migraphx_program_experimental_get_context(
     migraphx_context_t* out, const_migraphx_program_t program);
 
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_queue_options_destroy(migraphx_batch_queue_options_t batch_queue_options);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_batch_queue_options_assign_to(
+    migraphx_batch_queue_options_t output, const_migraphx_batch_queue_options_t input);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_queue_options_create(migraphx_batch_queue_options_t* batch_queue_options);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_batch_queue_options_set_max_batch(
+    migraphx_batch_queue_options_t batch_queue_options, size_t value);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_batch_queue_options_set_timeout(
+    migraphx_batch_queue_options_t batch_queue_options, size_t microseconds);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_result_destroy(migraphx_batch_result_t batch_result);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_batch_result_assign_to(
+    migraphx_batch_result_t output, const_migraphx_batch_result_t input);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_result_ready(bool* out, const_migraphx_batch_result_t batch_result);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_result_get(migraphx_arguments_t* out, const_migraphx_batch_result_t batch_result);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_batch_queue_destroy(migraphx_batch_queue_t batch_queue);
+
+MIGRAPHX_C_EXPORT migraphx_status migraphx_batch_queue_assign_to(
+    migraphx_batch_queue_t output, const_migraphx_batch_queue_t input);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_queue_create(migraphx_batch_queue_t* batch_queue,
+                            migraphx_program_t p,
+                            migraphx_batch_queue_options_t options);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_queue_submit(migraphx_batch_result_t* out,
+                            const_migraphx_batch_queue_t batch_queue,
+                            migraphx_program_parameters_t params);
+
+MIGRAPHX_C_EXPORT migraphx_status
+migraphx_batch_queue_max_batch(size_t* out, const_migraphx_batch_queue_t batch_queue);
+
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_destroy(migraphx_operation_t operation);
 
 MIGRAPHX_C_EXPORT migraphx_status migraphx_operation_assign_to(migraphx_operation_t output,
@@ -1238,6 +1238,80 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
     friend bool operator!=(const program& px, const program& py) { return not(px == py); }
 };
 
+/// Options for coalescing requests in a batch_queue
+struct batch_queue_options : MIGRAPHX_HANDLE_BASE(batch_queue_options)
+{
+    batch_queue_options() { this->make_handle(&migraphx_batch_queue_options_create); }
+
+    MIGRAPHX_HANDLE_CONSTRUCTOR(batch_queue_options)
+
+    /// The most samples to run together. By default this is the largest batch
+    /// the program accepts.
+    void set_max_batch(size_t value)
+    {
+        call(&migraphx_batch_queue_options_set_max_batch, this->get_handle_ptr(), value);
+    }
+
+    /// How long a request waits for others to join its batch
+    void set_timeout(size_t microseconds)
+    {
+        call(&migraphx_batch_queue_options_set_timeout, this->get_handle_ptr(), microseconds);
+    }
+};
+
+/// The outputs of a request submitted to a batch_queue
+struct batch_result : MIGRAPHX_HANDLE_BASE(batch_result)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(batch_result)
+
+    /// Check if the outputs are available without blocking
+    bool ready() const
+    {
+        bool pout;
+        call(&migraphx_batch_result_ready, &pout, this->get_handle_ptr());
+        return pout;
+    }
+
+    /// Wait for the outputs, throwing if running the batch failed
+    arguments get() const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_batch_result_get, &pout, this->get_handle_ptr());
+        return arguments(pout, own{});
+    }
+};
+
+/// Runs requests in batches on a worker thread. Requests are concatenated
+/// along the first dimension of every parameter, and the outputs are split
+/// back along their first dimension.
+struct batch_queue : MIGRAPHX_HANDLE_BASE(batch_queue)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(batch_queue)
+
+    batch_queue(const program& p, const batch_queue_options& options)
+    {
+        this->make_handle(
+            &migraphx_batch_queue_create, p.get_handle_ptr(), options.get_handle_ptr());
+    }
+
+    batch_queue(const program& p) : batch_queue(p, batch_queue_options{}) {}
+
+    /// Queue a request whose parameters each hold one or more samples
+    batch_result submit(const program_parameters& pparams) const
+    {
+        migraphx_batch_result_t pout;
+        call(&migraphx_batch_queue_submit, &pout, this->get_handle_ptr(), pparams.get_handle_ptr());
+        return batch_result(pout, own{});
+    }
+
+    size_t max_batch() const
+    {
+        size_t pout;
+        call(&migraphx_batch_queue_max_batch, &pout, this->get_handle_ptr());
+        return pout;
+    }
+};
+
 // options for migraphx file format options
 struct file_options : MIGRAPHX_HANDLE_BASE(file_options)
 {
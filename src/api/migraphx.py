@@ -297,6 +297,43 @@ def program(h):
              returns='migraphx::context')
 
 
+@auto_handle()
+def batch_queue_options(h):
+    h.constructor('create')
+    h.method('set_max_batch',
+             api.params(value='size_t'),
+             invoke='migraphx::set_max_batch($@)')
+    h.method('set_timeout',
+             api.params(microseconds='size_t'),
+             invoke='migraphx::set_timeout($@)')
+
+
+@api.handle('migraphx_batch_result', 'migraphx::batch_result')
+def batch_result(h):
+    h.method('ready',
+             invoke='migraphx::is_ready($@)',
+             returns='bool',
+             const=True)
+    h.method('get',
+             invoke='migraphx::get_result($@)',
+             returns='std::vector<migraphx::argument>',
+             const=True)
+
+
+@auto_handle()
+def batch_queue(h):
+    h.constructor(
+        'create',
+        api.params(p='migraphx::program',
+                   options='migraphx::batch_queue_options'))
+    h.method('submit',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>'),
+             returns='migraphx::batch_result',
+             const=True)
+    h.method('max_batch', returns='size_t', const=True)
+
+
 @auto_handle()
 def operation(h):
     h.constructor('create',
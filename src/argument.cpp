@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/argument.hpp>
+#include <migraphx/buffer_arena.hpp>
 #include <migraphx/functional.hpp>
 #include <unordered_map>
 
@@ -30,7 +31,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 argument::argument(const shape& s) : m_shape(s)
 {
-    auto buffer = make_shared_array<char>(s.bytes());
+    auto buffer = allocate_host_buffer(s.bytes());
     assign_buffer({[=]() mutable { return buffer.get(); }});
 }
 
@@ -0,0 +1,293 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/batch_queue.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct batch_request
+{
+    parameter_map params;
+    std::size_t samples = 0;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<std::vector<argument>> result;
+};
+
+static std::size_t batch_dim(const shape& s)
+{
+    if(s.dynamic())
+        return s.dyn_dims().front().max;
+    return s.lens().front();
+}
+
+static argument make_standard(const argument& a)
+{
+    if(a.get_shape().standard())
+        return a;
+    argument result{shape{a.get_shape().type(), a.get_shape().lens()}};
+    visit_all(result, a)([](auto output, auto input) {
+        std::copy(input.begin(), input.end(), output.begin());
+    });
+    return result;
+}
+
+static std::size_t row_bytes(const shape& s) { return s.bytes() / s.lens().front(); }
+
+struct batch_queue_impl
+{
+    program prog;
+    std::unordered_map<std::string, shape> param_shapes;
+    std::chrono::microseconds timeout;
+    std::size_t max_batch = 0;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<batch_request> requests;
+    std::size_t queued = 0;
+    bool stop          = false;
+    std::thread worker;
+
+    batch_queue_impl(program p, const batch_queue_options& options)
+        : prog(std::move(p)), param_shapes(prog.get_parameter_shapes()), timeout(options.timeout)
+    {
+        if(param_shapes.empty())
+            MIGRAPHX_THROW("batch_queue: Program has no parameters to batch");
+        std::vector<std::size_t> dims;
+        std::transform(param_shapes.begin(),
+                       param_shapes.end(),
+                       std::back_inserter(dims),
+                       [](const auto& p) { return batch_dim(p.second); });
+        max_batch = *std::min_element(dims.begin(), dims.end());
+        if(options.max_batch > 0)
+            max_batch = std::min(max_batch, options.max_batch);
+        if(max_batch == 0)
+            MIGRAPHX_THROW("batch_queue: Program has an empty batch dimension");
+        worker = std::thread([this] { this->run(); });
+    }
+
+    batch_queue_impl(const batch_queue_impl&)            = delete;
+    batch_queue_impl& operator=(const batch_queue_impl&) = delete;
+
+    ~batch_queue_impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    std::size_t count_samples(const parameter_map& params) const
+    {
+        std::size_t samples = 0;
+        for(const auto& [name, s] : param_shapes)
+        {
+            if(not contains(params, name))
+                MIGRAPHX_THROW("batch_queue: Missing parameter: " + name);
+            const auto& arg_shape = params.at(name).get_shape();
+            if(arg_shape.dynamic() or arg_shape.type() != s.type() or
+               arg_shape.ndim() != s.ndim())
+                MIGRAPHX_THROW("batch_queue: Incompatible shape for parameter: " + name);
+            if(not s.dynamic() and
+               not std::equal(arg_shape.lens().begin() + 1,
+                              arg_shape.lens().end(),
+                              s.lens().begin() + 1))
+                MIGRAPHX_THROW("batch_queue: Incompatible shape for parameter: " + name);
+            auto n = arg_shape.lens().front();
+            if(samples != 0 and n != samples)
+                MIGRAPHX_THROW("batch_queue: Parameters have different batch sizes");
+            samples = n;
+        }
+        if(samples == 0 or samples > max_batch)
+            MIGRAPHX_THROW("batch_queue: Request has " + std::to_string(samples) +
+                           " samples but the batch is limited to " + std::to_string(max_batch));
+        return samples;
+    }
+
+    batch_result submit(parameter_map params)
+    {
+        batch_request r;
+        r.samples = count_samples(params);
+        r.params  = std::move(params);
+        r.arrival = std::chrono::steady_clock::now();
+        auto result = r.result.get_future().share();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued += r.samples;
+            requests.push_back(std::move(r));
+        }
+        cv.notify_all();
+        return result;
+    }
+
+    // Requests can only share a batch when every dimension but the first matches
+    static bool compatible(const batch_request& x, const batch_request& y)
+    {
+        return std::all_of(x.params.begin(), x.params.end(), [&](const auto& p) {
+            const auto& xlens = p.second.get_shape().lens();
+            const auto& ylens = y.params.at(p.first).get_shape().lens();
+            return std::equal(xlens.begin() + 1, xlens.end(), ylens.begin() + 1, ylens.end());
+        });
+    }
+
+    std::vector<batch_request> take_batch()
+    {
+        std::vector<batch_request> batch;
+        std::size_t samples = 0;
+        while(not requests.empty() and samples + requests.front().samples <= max_batch and
+              (batch.empty() or compatible(batch.front(), requests.front())))
+        {
+            samples += requests.front().samples;
+            batch.push_back(std::move(requests.front()));
+            requests.pop_front();
+        }
+        queued -= samples;
+        return batch;
+    }
+
+    void run()
+    {
+        for(;;)
+        {
+            std::vector<batch_request> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return stop or not requests.empty(); });
+                if(requests.empty())
+                    return;
+                cv.wait_until(lock, requests.front().arrival + timeout, [&] {
+                    return stop or queued >= max_batch;
+                });
+                batch = take_batch();
+            }
+            process(batch);
+        }
+    }
+
+    std::size_t padded_size(std::size_t samples) const
+    {
+        std::size_t result = samples;
+        for(const auto& p : param_shapes)
+        {
+            if(p.second.dynamic())
+                result = std::max<std::size_t>(result, p.second.dyn_dims().front().min);
+            else
+                result = std::max(result, p.second.lens().front());
+        }
+        return result;
+    }
+
+    parameter_map concat(const std::vector<batch_request>& batch, std::size_t padded) const
+    {
+        parameter_map result;
+        for(const auto& p : param_shapes)
+        {
+            const auto& first = batch.front().params.at(p.first).get_shape();
+            auto lens         = first.lens();
+            lens.front()      = padded;
+            argument arg{shape{first.type(), lens}};
+            auto* data = arg.data();
+            for(const auto& r : batch)
+            {
+                auto input = make_standard(r.params.at(p.first));
+                std::memcpy(data, input.data(), input.get_shape().bytes());
+                data += input.get_shape().bytes();
+            }
+            // Padded samples are zeroed so they are still valid inputs
+            std::fill(data, arg.data() + arg.get_shape().bytes(), 0);
+            result[p.first] = arg;
+        }
+        return result;
+    }
+
+    void process(std::vector<batch_request>& batch)
+    {
+        std::size_t finished = 0;
+        try
+        {
+            auto samples = std::accumulate(
+                batch.begin(), batch.end(), std::size_t{0}, [](std::size_t n, const auto& r) {
+                    return n + r.samples;
+                });
+            auto padded  = padded_size(samples);
+            auto outputs = prog.eval(concat(batch, padded));
+            std::transform(outputs.begin(), outputs.end(), outputs.begin(), [&](const auto& out) {
+                const auto& s = out.get_shape();
+                if(s.type() == shape::tuple_type or s.ndim() == 0 or s.lens().front() != padded)
+                    MIGRAPHX_THROW("batch_queue: Output is not batched along the first dimension");
+                return make_standard(out);
+            });
+            std::size_t row = 0;
+            for(auto& r : batch)
+            {
+                std::vector<argument> results;
+                std::transform(outputs.begin(),
+                               outputs.end(),
+                               std::back_inserter(results),
+                               [&](const argument& out) {
+                                   auto lens    = out.get_shape().lens();
+                                   lens.front() = r.samples;
+                                   argument result{shape{out.get_shape().type(), lens}};
+                                   auto n = row_bytes(out.get_shape());
+                                   std::memcpy(result.data(), out.data() + row * n, r.samples * n);
+                                   return result;
+                               });
+                row += r.samples;
+                r.result.set_value(std::move(results));
+                finished++;
+            }
+        }
+        catch(...)
+        {
+            for(auto i = finished; i < batch.size(); i++)
+                batch[i].result.set_exception(std::current_exception());
+        }
+    }
+};
+
+batch_queue::batch_queue(program p, batch_queue_options options)
+    : impl(std::make_shared<batch_queue_impl>(std::move(p), options))
+{
+}
+
+batch_result batch_queue::submit(parameter_map params) const
+{
+    return impl->submit(std::move(params));
+}
+
+std::size_t batch_queue::max_batch() const { return impl->max_batch; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,106 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_BENCH_BENCH_HPP
+#define MIGRAPHX_GUARD_BENCH_BENCH_HPP
+
+#include <migraphx/value.hpp>
+#include <migraphx/time.hpp>
+#include <migraphx/config.hpp>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct options
+{
+    std::size_t iterations = 10;
+    std::size_t warmup     = 2;
+    std::string filter     = "";
+};
+
+/// The timings of a single benchmark configuration
+struct measurement
+{
+    std::string name;
+    std::string config;
+    /// Time of each iteration in nanoseconds
+    std::vector<double> samples = {};
+    /// Work done by one iteration, zero when it is not meaningful
+    double flops             = 0;
+    double bytes             = 0;
+    std::size_t instructions = 0;
+
+    double median() const;
+    double mean() const;
+    double stddev() const;
+    value to_value() const;
+};
+
+struct suite
+{
+    options opts;
+    std::vector<measurement> results = {};
+
+    bool selected(const std::string& name) const;
+
+    // Time run() after calling setup() each iteration, setup is not timed
+    template <class Setup, class Run>
+    std::vector<double> sample(Setup setup, Run run) const
+    {
+        for(std::size_t i = 0; i < opts.warmup; i++)
+        {
+            setup();
+            run();
+        }
+        std::vector<double> samples;
+        samples.reserve(opts.iterations);
+        for(std::size_t i = 0; i < opts.iterations; i++)
+        {
+            setup();
+            samples.push_back(time<std::chrono::duration<double, std::nano>>(run));
+        }
+        return samples;
+    }
+
+    template <class Run>
+    std::vector<double> sample(Run run) const
+    {
+        return sample([] {}, run);
+    }
+
+    void add(measurement m);
+};
+
+void operator_benchmarks(suite& s);
+void pass_benchmarks(suite& s);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
+
+#endif
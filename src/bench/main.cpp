@@ -0,0 +1,194 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+
+#include <migraphx/json.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/version.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+double measurement::median() const
+{
+    if(samples.empty())
+        return 0;
+    auto x = samples;
+    std::sort(x.begin(), x.end());
+    auto n = x.size();
+    if(n % 2 == 1)
+        return x[n / 2];
+    return (x[n / 2 - 1] + x[n / 2]) / 2;
+}
+
+double measurement::mean() const
+{
+    if(samples.empty())
+        return 0;
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+}
+
+double measurement::stddev() const
+{
+    if(samples.size() < 2)
+        return 0;
+    auto m   = mean();
+    auto sum = std::accumulate(samples.begin(), samples.end(), 0.0, [&](double acc, double x) {
+        return acc + (x - m) * (x - m);
+    });
+    return std::sqrt(sum / (samples.size() - 1));
+}
+
+value measurement::to_value() const
+{
+    auto t = median();
+    value result;
+    result["name"]      = name;
+    result["config"]    = config;
+    result["samples"]   = migraphx::to_value(samples);
+    result["median_ns"] = t;
+    result["mean_ns"]   = mean();
+    result["stddev_ns"] = stddev();
+    result["min_ns"]    = *std::min_element(samples.begin(), samples.end());
+    if(flops > 0)
+        result["gflops"] = flops / t;
+    if(bytes > 0)
+        result["gbytes_per_sec"] = bytes / t;
+    if(instructions > 0)
+        result["ns_per_instruction"] = t / instructions;
+    return result;
+}
+
+bool suite::selected(const std::string& name) const
+{
+    return opts.filter.empty() or contains(name, opts.filter);
+}
+
+void suite::add(measurement m)
+{
+    if(m.samples.empty())
+        MIGRAPHX_THROW("No samples for benchmark " + m.name);
+    auto t = m.median();
+    std::cerr << m.name << " [" << m.config << "]: " << t / 1e6 << "ms";
+    if(m.flops > 0)
+        std::cerr << ", " << m.flops / t << " GFLOP/s";
+    if(m.bytes > 0)
+        std::cerr << ", " << m.bytes / t << " GB/s";
+    if(m.instructions > 0)
+        std::cerr << ", " << t / m.instructions << " ns/instruction";
+    std::cerr << std::endl;
+    results.push_back(std::move(m));
+}
+
+static void usage()
+{
+    std::cerr << "Usage: migraphx-bench [options]\n"
+              << "    --iterations N   Timed iterations for each benchmark (default 10)\n"
+              << "    --warmup N       Untimed iterations before timing (default 2)\n"
+              << "    --filter NAME    Only run benchmarks whose name contains NAME\n"
+              << "    --output FILE    Write the JSON report to FILE instead of stdout\n";
+}
+
+int run(const std::vector<std::string>& args)
+{
+    suite s;
+    std::string output;
+    for(std::size_t i = 0; i < args.size(); i++)
+    {
+        const auto& arg = args[i];
+        if(arg == "-h" or arg == "--help")
+        {
+            usage();
+            return 0;
+        }
+        if(i + 1 >= args.size())
+        {
+            usage();
+            return 1;
+        }
+        const auto& next = args[++i];
+        if(arg == "--iterations")
+            s.opts.iterations = std::stoul(next);
+        else if(arg == "--warmup")
+            s.opts.warmup = std::stoul(next);
+        else if(arg == "--filter")
+            s.opts.filter = next;
+        else if(arg == "--output")
+            output = next;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if(s.opts.iterations == 0)
+        MIGRAPHX_THROW("At least one iteration is required");
+
+    operator_benchmarks(s);
+    pass_benchmarks(s);
+
+    value report;
+    report["version"] = std::to_string(MIGRAPHX_VERSION_MAJOR) + "." +
+                        std::to_string(MIGRAPHX_VERSION_MINOR) + "." +
+                        std::to_string(MIGRAPHX_VERSION_PATCH);
+    report["iterations"] = s.opts.iterations;
+    report["warmup"]     = s.opts.warmup;
+    std::vector<value> results;
+    std::transform(s.results.begin(),
+                   s.results.end(),
+                   std::back_inserter(results),
+                   [](const auto& m) { return m.to_value(); });
+    report["results"] = results;
+
+    auto json = to_json_string(report);
+    if(output.empty())
+    {
+        std::cout << json << std::endl;
+    }
+    else
+    {
+        std::ofstream os(output);
+        os << json << std::endl;
+    }
+    return 0;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
+
+int main(int argc, const char* argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    return migraphx::bench::run(args);
+}
@@ -0,0 +1,224 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static std::string to_config(const std::vector<shape>& inputs)
+{
+    std::vector<std::string> dims;
+    std::transform(inputs.begin(), inputs.end(), std::back_inserter(dims), [](const shape& x) {
+        auto result = to_string_range(x.lens(), "x");
+        if(not x.standard())
+            result += "(" + to_string_range(x.strides(), ",") + ")";
+        return result;
+    });
+    return join_strings(dims, ", ");
+}
+
+// Builds a single instruction program on the ref target and times its evaluation
+static void run_op(suite& s,
+                   const std::string& name,
+                   const operation& op,
+                   const std::vector<shape>& inputs,
+                   const std::vector<literal>& literals,
+                   double flops)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    std::vector<instruction_ref> args;
+    parameter_map params;
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        auto pname = "x" + std::to_string(i);
+        args.push_back(mm->add_parameter(pname, inputs[i]));
+        params[pname] = generate_argument(inputs[i], i);
+    }
+    for(const auto& l : literals)
+        args.push_back(mm->add_literal(l));
+    auto r = mm->add_instruction(op, args);
+    mm->add_return({r});
+    auto out = r->get_shape();
+    p.compile(make_target("ref"));
+
+    measurement m;
+    m.name    = name;
+    m.config  = to_config(inputs);
+    m.samples = s.sample([&] { p.eval(params); });
+    m.flops   = flops;
+    m.bytes   = std::accumulate(inputs.begin(),
+                              inputs.end(),
+                              double(out.bytes()),
+                              [](double acc, const shape& x) { return acc + x.bytes(); });
+    s.add(std::move(m));
+}
+
+static void run_op(suite& s,
+                   const std::string& name,
+                   const operation& op,
+                   const std::vector<shape>& inputs,
+                   double flops = 0)
+{
+    run_op(s, name, op, inputs, {}, flops);
+}
+
+static void bench_convolution(suite& s)
+{
+    struct conv_config
+    {
+        std::vector<std::size_t> input;
+        std::vector<std::size_t> weights;
+        std::size_t padding;
+        std::size_t stride;
+    };
+    std::vector<conv_config> configs = {{{1, 16, 32, 32}, {32, 16, 3, 3}, 1, 1},
+                                        {{4, 32, 28, 28}, {32, 32, 3, 3}, 1, 1},
+                                        {{1, 3, 112, 112}, {16, 3, 7, 7}, 3, 2}};
+    for(const auto& c : configs)
+    {
+        auto op = make_op("convolution",
+                          {{"padding", {c.padding, c.padding}}, {"stride", {c.stride, c.stride}}});
+        shape xs{shape::float_type, c.input};
+        shape ws{shape::float_type, c.weights};
+        auto out = op.compute_shape({xs, ws});
+        // Each output element is a dot product over the filter window
+        double flops = 2.0 * out.elements() * c.weights[1] * c.weights[2] * c.weights[3];
+        run_op(s, "convolution", op, {xs, ws}, flops);
+    }
+}
+
+static void bench_dot(suite& s)
+{
+    std::vector<std::vector<std::size_t>> configs = {
+        {1, 64, 64, 64}, {1, 256, 256, 256}, {8, 128, 64, 128}};
+    for(const auto& c : configs)
+    {
+        auto b = c[0];
+        auto m = c[1];
+        auto k = c[2];
+        auto n = c[3];
+        auto batch = [&](std::vector<std::size_t> lens) {
+            if(b > 1)
+                lens.insert(lens.begin(), b);
+            return lens;
+        };
+        shape as{shape::float_type, batch({m, k})};
+        shape bs{shape::float_type, batch({k, n})};
+        run_op(s, "dot", make_op("dot"), {as, bs}, 2.0 * b * m * n * k);
+    }
+}
+
+static void bench_reduce(suite& s)
+{
+    std::vector<std::pair<std::vector<std::size_t>, std::vector<int64_t>>> configs = {
+        {{64, 1024}, {1}}, {{32, 64, 64}, {0}}, {{16, 128, 128}, {1, 2}}};
+    for(const auto& [lens, axes] : configs)
+    {
+        shape xs{shape::float_type, lens};
+        run_op(s, "reduce_sum", make_op("reduce_sum", {{"axes", axes}}), {xs}, xs.elements());
+    }
+}
+
+static void bench_softmax(suite& s)
+{
+    std::vector<std::pair<std::vector<std::size_t>, int64_t>> configs = {
+        {{64, 1024}, 1}, {{16, 128, 128}, 2}, {{16, 128, 128}, 0}};
+    for(const auto& [lens, axis] : configs)
+    {
+        shape xs{shape::float_type, lens};
+        run_op(s, "softmax", make_op("softmax", {{"axis", axis}}), {xs});
+    }
+}
+
+static void bench_gather(suite& s)
+{
+    std::vector<std::pair<std::vector<std::size_t>, std::size_t>> configs = {
+        {{1000, 128}, 256}, {{30000, 64}, 4096}};
+    for(const auto& [lens, n] : configs)
+    {
+        shape xs{shape::float_type, lens};
+        std::vector<int32_t> indices(n);
+        std::generate(indices.begin(), indices.end(), [&, i = 0]() mutable {
+            return static_cast<int32_t>((i++ * 7919) % lens.front());
+        });
+        literal l{shape{shape::int32_type, {n}}, indices};
+        run_op(s, "gather", make_op("gather", {{"axis", 0}}), {xs}, {l}, 0);
+    }
+}
+
+static void bench_pointwise(suite& s)
+{
+    std::vector<std::vector<std::size_t>> configs = {{1024}, {1 << 20}, {64, 56, 56}};
+    for(const auto& lens : configs)
+    {
+        shape xs{shape::float_type, lens};
+        run_op(s, "add", make_op("add"), {xs, xs}, xs.elements());
+        run_op(s, "tanh", make_op("tanh"), {xs});
+    }
+    // Scalar, last axis and channel broadcasts have their own loops, while mixed layouts such as
+    // a transposed input go through the generic strided path
+    shape xs{shape::float_type, {64, 1024}};
+    shape ss{shape::float_type, {64, 1024}, {0, 0}};
+    run_op(s, "add", make_op("add"), {xs, ss}, xs.elements());
+    shape bs{shape::float_type, {64, 1024}, {0, 1}};
+    run_op(s, "add", make_op("add"), {xs, bs}, xs.elements());
+    shape ts{shape::float_type, {64, 1024}, {1, 64}};
+    run_op(s, "add", make_op("add"), {xs, ts}, xs.elements());
+    run_op(s, "tanh", make_op("tanh"), {ts});
+    shape ns{shape::float_type, {8, 64, 28, 28}};
+    shape cs{shape::float_type, {8, 64, 28, 28}, {0, 1, 0, 0}};
+    run_op(s, "add", make_op("add"), {ns, cs}, ns.elements());
+}
+
+void operator_benchmarks(suite& s)
+{
+    std::vector<std::pair<std::string, void (*)(suite&)>> benchmarks = {
+        {"convolution", &bench_convolution},
+        {"dot", &bench_dot},
+        {"reduce_sum", &bench_reduce},
+        {"softmax", &bench_softmax},
+        {"gather", &bench_gather},
+        {"pointwise", &bench_pointwise}};
+    for(const auto& [name, f] : benchmarks)
+    {
+        if(s.selected(name))
+            f(s);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+
+#include <migraphx/module.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/simplify_algebra.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/schedule.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/serialize.hpp>
+
+namespace migraphx {
+namespace bench {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// An operator that writes into its last input, like a lowered target operator
+struct bench_op
+{
+    std::string name() const { return "bench::op"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        check_shapes{inputs, *this}.has(2, 3);
+        return inputs.back();
+    }
+    argument compute(const shape&, const std::vector<argument>& args) const
+    {
+        return args.back();
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+// A scheduler model with two streams that doesn't insert any synchronization
+struct bench_schedule_model
+{
+    std::size_t concurrency() const { return 2; }
+    void sched(module&, instruction_ref, std::size_t) const {}
+    void wait(module&, instruction_ref, std::size_t) const {}
+    void record(module&, instruction_ref, std::size_t) const {}
+    std::size_t weight(const operation& op) const
+    {
+        if(op.name() == "bench::op")
+            return 4;
+        return 1;
+    }
+};
+
+// Layers of (x + a) * b + c that simplify_algebra can rewrite and fold
+static module make_algebra_module(std::size_t layers)
+{
+    module m;
+    shape s{shape::float_type, {1, 64}};
+    auto x = m.add_parameter("x", s);
+    for(std::size_t i = 0; i < layers; i++)
+    {
+        auto a   = m.add_literal(generate_literal(s, 3 * i));
+        auto b   = m.add_literal(generate_literal(s, 3 * i + 1));
+        auto c   = m.add_literal(generate_literal(s, 3 * i + 2));
+        auto add = m.add_instruction(make_op("add"), x, a);
+        auto mul = m.add_instruction(make_op("mul"), add, b);
+        x        = m.add_instruction(make_op("relu"), m.add_instruction(make_op("add"), mul, c));
+    }
+    m.add_return({x});
+    return m;
+}
+
+// Layers with a skip connection so allocations have overlapping lifetimes
+static module make_allocation_module(std::size_t layers)
+{
+    module m;
+    shape s{shape::float_type, {1, 64, 32, 32}};
+    auto x    = m.add_parameter("x", s);
+    auto skip = x;
+    for(std::size_t i = 0; i < layers; i++)
+    {
+        auto a1 = m.add_instruction(make_op("allocate", {{"shape", to_value(s)}}));
+        auto y  = m.add_instruction(bench_op{}, x, a1);
+        auto a2 = m.add_instruction(make_op("allocate", {{"shape", to_value(s)}}));
+        x       = m.add_instruction(bench_op{}, y, skip, a2);
+        if(i % 4 == 3)
+            skip = x;
+    }
+    m.add_return({x});
+    return m;
+}
+
+// Residual layers of two independent branches joined back together
+static module make_branch_module(std::size_t layers)
+{
+    module m;
+    shape s{shape::float_type, {1, 64}};
+    auto x = m.add_parameter("x", s);
+    for(std::size_t i = 0; i < layers; i++)
+    {
+        auto a1 = m.add_instruction(make_op("allocate", {{"shape", to_value(s)}}));
+        auto y  = m.add_instruction(bench_op{}, x, a1);
+        auto a2 = m.add_instruction(make_op("allocate", {{"shape", to_value(s)}}));
+        auto z  = m.add_instruction(bench_op{}, x, a2);
+        x       = m.add_instruction(make_op("add"), y, z);
+    }
+    m.add_return({x});
+    return m;
+}
+
+template <class Pass, class Make>
+static void
+run_pass(suite& s, const Pass& pass, Make make, const std::vector<std::size_t>& sizes)
+{
+    for(auto layers : sizes)
+    {
+        module m;
+        std::size_t n = 0;
+        measurement r;
+        r.name    = pass.name();
+        r.config  = std::to_string(layers) + " layers";
+        r.samples = s.sample(
+            [&] {
+                m = make(layers);
+                n = m.size();
+            },
+            [&] { pass.apply(m); });
+        r.instructions = n;
+        s.add(std::move(r));
+    }
+}
+
+void pass_benchmarks(suite& s)
+{
+    if(s.selected("simplify_algebra"))
+        run_pass(s, simplify_algebra{}, &make_algebra_module, {16, 64, 256});
+    if(s.selected("memory_coloring"))
+        run_pass(s, memory_coloring{"allocate"}, &make_allocation_module, {16, 64, 256});
+    // The scheduler's ordering grows with the number of paths through the
+    // graph, so it is measured on shallower graphs
+    if(s.selected("schedule"))
+        run_pass(s, schedule{bench_schedule_model{}}, &make_branch_module, {4, 8, 16});
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace bench
+} // namespace migraphx
@@ -0,0 +1,170 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/buffer_arena.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Sizes are rounded up to one of four classes between each power of two, so a freed buffer can
+// be reused by allocations of a similar size while wasting at most a quarter of it
+static std::size_t size_class(std::size_t n)
+{
+    if(n <= 64)
+        return 64;
+    std::size_t step = 16;
+    while((step * 8) < n)
+        step *= 2;
+    return (n + step - 1) / step * step;
+}
+
+struct buffer_arena::impl : std::enable_shared_from_this<buffer_arena::impl>
+{
+    explicit impl(std::size_t max_free) : max_free_bytes(max_free) {}
+
+    std::mutex mutex;
+    std::unordered_map<std::size_t, std::vector<char*>> free_buffers;
+    std::size_t max_free_bytes;
+    // Set once every copy of the arena is gone, buffers are then freed when they are returned
+    bool released = false;
+    buffer_arena_stats stats;
+
+    ~impl()
+    {
+        for(auto&& p : free_buffers)
+        {
+            for(char* buffer : p.second)
+                delete[] buffer; // NOLINT
+        }
+    }
+
+    std::shared_ptr<char> allocate(std::size_t n, bool zero)
+    {
+        auto m       = size_class(n);
+        char* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.allocations++;
+            auto it = free_buffers.find(m);
+            if(it == free_buffers.end() or it->second.empty())
+            {
+                stats.heap_allocations++;
+                stats.reserved_bytes += m;
+            }
+            else
+            {
+                buffer = it->second.back();
+                it->second.pop_back();
+                stats.free_bytes -= m;
+            }
+        }
+        if(buffer == nullptr)
+            buffer = zero ? new char[m]() : new char[m]; // NOLINT
+        else if(zero)
+            std::fill(buffer, buffer + n, 0);
+        // The deleter keeps the arena alive until every buffer has been returned
+        auto self = shared_from_this();
+        return {buffer, [self, m](char* p) { self->recycle(p, m); }};
+    }
+
+    void recycle(char* buffer, std::size_t m)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(not released and stats.free_bytes + m <= max_free_bytes)
+            {
+                free_buffers[m].push_back(buffer);
+                stats.free_bytes += m;
+                return;
+            }
+            stats.reserved_bytes -= m;
+        }
+        delete[] buffer; // NOLINT
+    }
+
+    void release(bool last = false)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto&& p : free_buffers)
+        {
+            for(char* buffer : p.second)
+                delete[] buffer; // NOLINT
+        }
+        free_buffers.clear();
+        stats.reserved_bytes -= stats.free_bytes;
+        stats.free_bytes = 0;
+        released         = released or last;
+    }
+};
+
+buffer_arena::buffer_arena(std::size_t max_free_bytes)
+    : pimpl(std::make_shared<impl>(max_free_bytes))
+{
+    // Buffers still in use can outlive the arena, but nothing is kept for them once the last
+    // copy of the arena is destroyed
+    auto p = pimpl;
+    owner  = std::shared_ptr<void>(nullptr, [p](void*) { p->release(true); });
+}
+
+std::shared_ptr<char> buffer_arena::allocate(std::size_t n, bool zero) const
+{
+    return pimpl->allocate(n, zero);
+}
+
+void buffer_arena::release() const { pimpl->release(); }
+
+buffer_arena_stats buffer_arena::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(pimpl->mutex);
+    return pimpl->stats;
+}
+
+static const buffer_arena_scope*& current_scope()
+{
+    thread_local const buffer_arena_scope* scope = nullptr;
+    return scope;
+}
+
+buffer_arena_scope::buffer_arena_scope(const buffer_arena& a, bool zero)
+    : arena(&a), zero_init(zero), previous(current_scope())
+{
+    current_scope() = this;
+}
+
+buffer_arena_scope::~buffer_arena_scope() { current_scope() = previous; }
+
+std::shared_ptr<char> allocate_host_buffer(std::size_t n)
+{
+    const auto* scope = current_scope();
+    if(scope == nullptr)
+        return make_shared_array<char>(n);
+    return scope->arena->allocate(n, scope->zero_init);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,251 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/calibration.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/value.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Smallest power of two that is larger than x
+static float range_for(float x)
+{
+    if(x == 0)
+        return 0;
+    int e = 0;
+    std::frexp(x, &e);
+    return std::ldexp(1.0f, e);
+}
+
+calibration_histogram::calibration_histogram(std::size_t bins)
+    : counts(std::max<std::size_t>(bins, 1))
+{
+}
+
+void calibration_histogram::grow(float r)
+{
+    if(r <= range)
+        return;
+    if(range > 0)
+    {
+        auto factor = static_cast<std::size_t>(r / range);
+        std::vector<std::uint64_t> c(counts.size());
+        for(std::size_t i = 0; i < counts.size(); i++)
+            c[i / factor] += counts[i];
+        counts = std::move(c);
+    }
+    range = r;
+}
+
+void calibration_histogram::merge(const calibration_histogram& h)
+{
+    assert(h.counts.size() == counts.size());
+    grow(h.range);
+    std::size_t factor = h.range > 0 ? static_cast<std::size_t>(range / h.range) : 1;
+    for(std::size_t i = 0; i < h.counts.size(); i++)
+        counts[i / factor] += h.counts[i];
+    max_abs = std::max(max_abs, h.max_abs);
+}
+
+void calibration_histogram::add(const argument& arg)
+{
+    std::mutex m;
+    arg.visit([&](auto input) {
+        const auto& s = input.get_shape();
+        auto for_each_value = [&](std::size_t start, std::size_t last, auto f) {
+            if(s.standard())
+            {
+                std::for_each(input.data() + start, input.data() + last, f);
+                return;
+            }
+            shape_index it{s, start};
+            for(std::size_t i = start; i < last; i++, ++it)
+                f(input.data()[it.offset()]);
+        };
+        par_for_chunks(s.elements(), 4096, [&](std::size_t start, std::size_t last) {
+            // Find the range of the chunk first while it is still in cache, then bin it
+            calibration_histogram h{counts.size()};
+            for_each_value(start, last, [&](auto v) {
+                float x = std::fabs(static_cast<float>(v));
+                if(std::isfinite(x))
+                    h.max_abs = std::max(h.max_abs, x);
+            });
+            h.range    = range_for(h.max_abs);
+            auto nbins = h.counts.size();
+            for_each_value(start, last, [&](auto v) {
+                float x = std::fabs(static_cast<float>(v));
+                if(not std::isfinite(x))
+                    return;
+                std::size_t bin = 0;
+                if(h.range > 0)
+                    bin = std::min<std::size_t>(nbins - 1, x / h.range * nbins);
+                h.counts[bin]++;
+            });
+            std::lock_guard<std::mutex> lock(m);
+            this->merge(h);
+        });
+    });
+}
+
+std::uint64_t calibration_histogram::total() const
+{
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+}
+
+float calibration_histogram::percentile_threshold(double p) const
+{
+    auto target       = static_cast<double>(total()) * p / 100.0;
+    std::uint64_t sum = 0;
+    for(std::size_t i = 0; i < counts.size(); i++)
+    {
+        sum += counts[i];
+        if(static_cast<double>(sum) >= target)
+            return std::min(max_abs, range * (i + 1) / counts.size());
+    }
+    return max_abs;
+}
+
+// Picks the threshold whose clipped and int8 quantized distribution is the closest to the
+// original distribution by KL divergence
+float calibration_histogram::entropy_threshold() const
+{
+    const std::size_t levels = 128;
+    // Weight given to the quantized bins that lost all of their values, so the divergence stays
+    // finite and clipping them is still penalized
+    const double eps = 1e-4;
+    auto nbins       = counts.size();
+    if(nbins <= levels)
+        return max_abs;
+    std::vector<std::uint64_t> outliers(nbins + 1, 0);
+    for(std::size_t i = nbins; i > 0; i--)
+        outliers[i - 1] = outliers[i] + counts[i - 1];
+
+    double best_kl     = std::numeric_limits<double>::max();
+    std::size_t best_i = nbins;
+    std::vector<double> p;
+    std::vector<double> q;
+    for(std::size_t i = levels; i <= nbins; i++)
+    {
+        // The reference distribution with the clipped values folded into the last bin
+        p.assign(counts.begin(), counts.begin() + i);
+        p.back() += outliers[i];
+        // Merge the bins below the threshold into the quantized levels, without the clipped
+        // values, and spread each level evenly over the bins that are not empty in p
+        q.assign(i, 0);
+        for(std::size_t j = 0; j < levels; j++)
+        {
+            auto start = j * i / levels;
+            auto last  = (j + 1) * i / levels;
+            double sum = std::accumulate(counts.begin() + start, counts.begin() + last, 0.0);
+            std::size_t nonzero = std::count_if(
+                p.begin() + start, p.begin() + last, [](double x) { return x > 0; });
+            if(nonzero == 0)
+                continue;
+            for(std::size_t k = start; k < last; k++)
+            {
+                if(p[k] > 0)
+                    q[k] = std::max(sum / nonzero, eps);
+            }
+        }
+        double total_p = std::accumulate(p.begin(), p.end(), 0.0);
+        double total_q = std::accumulate(q.begin(), q.end(), 0.0);
+        if(total_p == 0 or total_q == 0)
+            continue;
+        double kl = 0;
+        for(std::size_t k = 0; k < i; k++)
+        {
+            if(p[k] > 0)
+                kl += p[k] / total_p * std::log((p[k] / total_p) / (q[k] / total_q));
+        }
+        if(kl < best_kl)
+        {
+            best_kl = kl;
+            best_i  = i;
+        }
+    }
+    return std::min(max_abs, range * best_i / nbins);
+}
+
+float calibration_histogram::threshold(const calibration_options& options) const
+{
+    if(range == 0)
+        return 0;
+    switch(options.method)
+    {
+    case calibration_method::max_abs: return max_abs;
+    case calibration_method::percentile: return percentile_threshold(options.percentile);
+    case calibration_method::entropy: return entropy_threshold();
+    }
+    MIGRAPHX_THROW("CALIBRATION: unknown calibration method");
+}
+
+std::pair<float, float>
+calibration_histogram::quant_params(const calibration_options& options) const
+{
+    // scale and shift is need for only int8 type, and we do not
+    // consider shift, so set shift to 0
+    if(total() == 0)
+        return {64.0f, 0.0f};
+    auto t = threshold(options);
+    // if all values are 0, no need to do scaling
+    if(t == 0.0f)
+        return {1.0f, 0.0f};
+    return {127.0f / t, 0.0f};
+}
+
+void save_calibration(const std::vector<std::pair<float, float>>& quant_params,
+                      const std::string& filename)
+{
+    value v = value::array{};
+    for(const auto& param : quant_params)
+        v.push_back(value::array{param.first, param.second});
+    auto s = to_json_string(v);
+    write_buffer(filename, s.data(), s.size());
+}
+
+std::vector<std::pair<float, float>> load_calibration(const std::string& filename)
+{
+    auto v = from_json_string(read_string(filename));
+    if(not v.is_array())
+        MIGRAPHX_THROW("CALIBRATION: invalid calibration table: " + filename);
+    std::vector<std::pair<float, float>> result;
+    std::transform(v.begin(), v.end(), std::back_inserter(result), [&](const value& x) {
+        if(x.size() != 2)
+            MIGRAPHX_THROW("CALIBRATION: invalid calibration table: " + filename);
+        return std::make_pair(x[0].to<float>(), x[1].to<float>());
+    });
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
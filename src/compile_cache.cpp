@@ -0,0 +1,233 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <cstdlib>
+#define MIGRAPHX_ENVIRON _environ
+#else
+extern char** environ; // NOLINT
+#define MIGRAPHX_ENVIRON environ
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_DIR)
+// Size of the cache in megabytes
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_SIZE)
+
+compile_cache::compile_cache(fs::path dir, std::size_t max_bytes)
+    : directory(std::move(dir)), max_size(max_bytes)
+{
+}
+
+optional<compile_cache> compile_cache::from_env()
+{
+    auto dir = string_value_of(MIGRAPHX_COMPILE_CACHE_DIR{});
+    if(dir.empty())
+        return nullopt;
+    return compile_cache{dir, value_of(MIGRAPHX_COMPILE_CACHE_SIZE{}, 4096) * 1024 * 1024};
+}
+
+// Hash the literal data in place, instead of copying it into the value
+static value literal_key(const literal& l)
+{
+    value result;
+    result["shape"] = migraphx::to_value(l.get_shape());
+    result["data"] =
+        hash_value(std::string_view{l.data(), l.empty() ? 0 : l.get_shape().bytes()});
+    return result;
+}
+
+// Passes and targets read their switches from MIGRAPHX_* variables, so every one that is set
+// is part of the description, apart from the ones that only configure the cache itself
+static value compile_env()
+{
+    // Sorted, so the order of the environment doesn't change the key
+    std::map<std::string, std::string> vars;
+    for(char** e = MIGRAPHX_ENVIRON; e != nullptr and *e != nullptr; e++)
+    {
+        std::string var{*e};
+        auto eq = var.find('=');
+        if(eq == std::string::npos)
+            continue;
+        auto name = var.substr(0, eq);
+        if(not starts_with(name, "MIGRAPHX_") or starts_with(name, "MIGRAPHX_COMPILE_CACHE_"))
+            continue;
+        vars[name] = var.substr(eq + 1);
+    }
+    value result = value::object{};
+    for(const auto& [name, v] : vars)
+        result[name] = v;
+    return result;
+}
+
+value compile_cache::describe(const program& p,
+                              const target& t,
+                              const context& ctx,
+                              const compile_options& options)
+{
+    assert(not p.is_compiled());
+    value result;
+    result["migraphx_version"] = get_migraphx_version();
+    result["target"]           = t.name();
+    result["context"]          = ctx.to_value();
+    result["offload_copy"]     = options.offload_copy;
+    result["fast_math"]        = options.fast_math;
+    result["exhaustive_tune"]  = options.exhaustive_tune;
+    result["env"]              = compile_env();
+    result["program"]          = p.to_value(&literal_key);
+    return result;
+}
+
+std::string compile_cache::key(const value& description)
+{
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << description.hash();
+    return ss.str();
+}
+
+fs::path compile_cache::path(const std::string& key) const { return directory / (key + ".mxr"); }
+
+// The description an entry was stored for
+static fs::path description_path(const fs::path& file)
+{
+    auto result = file;
+    return result.replace_extension(".json");
+}
+
+optional<program> compile_cache::load(const value& description) const
+{
+    auto file = this->path(key(description));
+    std::error_code ec;
+    if(not fs::exists(file, ec))
+        return nullopt;
+    try
+    {
+        // Another description with the same hash is a miss, and its entry is left for it
+        if(read_string(description_path(file).string()) != to_json_string(description))
+            return nullopt;
+        file_options options;
+        options.mmap = true;
+        auto p       = migraphx::load(file.string(), options);
+        // Mark the entry as recently used for eviction
+        fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+        return p;
+    }
+    catch(const std::exception&)
+    {
+        // The entry is stale or truncated, so it will be compiled again
+        fs::remove(file, ec);
+        fs::remove(description_path(file), ec);
+        return nullopt;
+    }
+}
+
+void compile_cache::store(const value& description, const program& p) const
+{
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    auto k    = key(description);
+    auto file = this->path(k);
+    // Write to unique files first so that concurrent readers never see a partial entry
+    auto tmp      = directory / unique_string(k + ".tmp");
+    auto tmp_desc = directory / unique_string(k + ".tmp");
+    try
+    {
+        auto text = to_json_string(description);
+        write_buffer(tmp_desc.string(), text.data(), text.size());
+        fs::rename(tmp_desc, description_path(file));
+        migraphx::save(p, tmp.string());
+        fs::rename(tmp, file);
+    }
+    catch(const std::exception&)
+    {
+        // A cache that can't be written to only costs recompilation
+        fs::remove(tmp, ec);
+        fs::remove(tmp_desc, ec);
+        return;
+    }
+    this->evict();
+}
+
+void compile_cache::evict() const
+{
+    if(max_size == 0)
+        return;
+    struct entry
+    {
+        fs::path file;
+        std::size_t size;
+        fs::file_time_type time;
+    };
+    std::vector<entry> entries;
+    std::size_t total = 0;
+    std::error_code ec;
+    for(const auto& de : fs::directory_iterator(directory, ec))
+    {
+        if(de.path().extension() != ".mxr")
+            continue;
+        auto size = fs::file_size(de.path(), ec);
+        if(ec)
+            continue;
+        auto time = fs::last_write_time(de.path(), ec);
+        if(ec)
+            continue;
+        entries.push_back({de.path(), size, time});
+        total += size;
+    }
+    if(total <= max_size)
+        return;
+    std::sort(entries.begin(), entries.end(), [](const entry& x, const entry& y) {
+        return x.time < y.time;
+    });
+    for(const auto& e : entries)
+    {
+        if(total <= max_size)
+            break;
+        if(fs::remove(e.file, ec))
+            total -= e.size;
+        fs::remove(description_path(e.file), ec);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -35,6 +35,13 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 void dead_code_elimination::apply(program& p) const { p.remove_unused_modules(); }
 
+bool is_removable_when_unused(instruction_ref ins)
+{
+    return ins->get_shape().dynamic() or ins->get_shape().elements() > 0 or
+           ins->get_shape().type() == shape::tuple_type or ins->name().front() == '@' or
+           contains({"identity", "allocate"}, ins->name()) or ins->is_undefined();
+}
+
 void dead_code_elimination::apply(module& m) const
 {
     auto last = std::prev(m.end());
@@ -48,13 +55,7 @@ void dead_code_elimination::apply(module& m) const
         // Skip the last instruction
         if(i == last)
             break;
-        // Skip instruction with empty shape as output unless its [dynamic, builtin, undefined,
-        // identity, allocate or tuple_type]
-        if((not i->get_shape().dynamic() and
-            (i->get_shape().elements() == 0 and
-             i->get_shape().type() != migraphx::shape::tuple_type)) and
-           not(i->name().front() == '@') and not contains({"identity", "allocate"}, i->name()) and
-           not i->is_undefined())
+        if(not is_removable_when_unused(i))
             continue;
         assert(std::distance(m.begin(), i) <= std::distance(m.begin(), last));
         std::unordered_set<instruction_ref> visited;
@@ -0,0 +1,86 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/deduplicate_literals.hpp>
+#include <migraphx/literal_storage.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+#include <iostream>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_DEDUPLICATE_LITERALS)
+
+void deduplicate_literals::apply(program& p) const
+{
+    literal_storage storage;
+    std::size_t merged = 0;
+    for(auto* m : p.get_modules())
+    {
+        // Literals already in this module by their buffer
+        std::unordered_multimap<const char*, instruction_ref> literals;
+        auto ins = m->begin();
+        while(ins != m->end())
+        {
+            auto next = std::next(ins);
+            if(ins->name() != "@literal" or ins->get_literal().empty())
+            {
+                ins = next;
+                continue;
+            }
+            auto l     = storage.insert(ins->get_literal());
+            auto found = range(literals.equal_range(l.data()));
+            auto it    = std::find_if(found.begin(), found.end(), [&](const auto& pp) {
+                return pp.second->get_shape() == l.get_shape();
+            });
+            if(it != found.end())
+            {
+                m->replace_instruction(ins, it->second);
+                m->remove_instruction(ins);
+                merged++;
+                ins = next;
+                continue;
+            }
+            if(not l.shares_buffer(ins->get_literal()))
+            {
+                auto shared = m->insert_literal(ins, l);
+                m->replace_instruction(ins, shared);
+                m->remove_instruction(ins);
+                ins = shared;
+            }
+            literals.emplace(l.data(), ins);
+            ins = next;
+        }
+    }
+    if(enabled(MIGRAPHX_TRACE_DEDUPLICATE_LITERALS{}))
+        std::cout << "deduplicate_literals: merged " << merged << " instructions, "
+                  << storage.size() << " buffers using " << storage.bytes() << " bytes, "
+                  << storage.shared_bytes() << " bytes shared" << std::endl;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -26,51 +26,73 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/ranges.hpp>
-#include <migraphx/functional.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/env.hpp>
 
-#include <unordered_set>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-template <class Range>
-void cse_range(module& m, Range&& r)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_ELIMINATE_COMMON_SUBEXPRESSION)
+
+// Structural hash that is consistent with instruction::operator==: two equal
+// instructions always produce the same hash. Since the module is visited in
+// order, the inputs have already been replaced by their representatives so
+// hashing the input addresses is enough to identify identical subtrees.
+static std::size_t hash_instruction(instruction_ref ins)
 {
-    std::unordered_multimap<std::string, instruction_ref> instructions;
-    std::unordered_set<instruction_ref> processed_ins;
-    for(auto ins : r)
+    std::size_t h = hash_value(ins->name());
+    hash_combine(h, ins->get_operator().to_value().hash());
+    const auto& s = ins->get_shape();
+    hash_combine(h, s.type());
+    if(not s.dynamic())
+    {
+        for(auto len : s.lens())
+            hash_combine(h, len);
+        for(auto stride : s.strides())
+            hash_combine(h, stride);
+    }
+    for(auto input : ins->inputs())
+        hash_combine(h, input);
+    for(auto* smod : ins->module_inputs())
+        hash_combine(h, smod);
+    if(ins->name() == "@literal")
+    {
+        const auto& l = ins->get_literal();
+        hash_combine(h, std::string_view{l.data(), l.empty() ? 0 : l.get_shape().bytes()});
+    }
+    return h;
+}
+
+void eliminate_common_subexpression::apply(module& m) const
+{
+    std::unordered_multimap<std::size_t, instruction_ref> instructions;
+    std::size_t merged = 0;
+    for(auto ins : iterator_for(m))
     {
         // Skip dead instructions
         if(ins->outputs().empty())
             continue;
 
-        // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
-        for(const auto& pp : found_instructions)
+        auto h     = hash_instruction(ins);
+        auto found = range(instructions.equal_range(h));
+        auto it    = std::find_if(
+            found.begin(), found.end(), [&](const auto& pp) { return *pp.second == *ins; });
+        if(it != found.end())
         {
-            auto eq = pp.second;
-            if(contains(processed_ins, eq))
-                continue;
-            if(*eq != *ins)
-                continue;
-            m.replace_instruction(ins, eq);
-            processed_ins.emplace(ins);
-            std::vector<instruction_ref> outputs;
-            std::copy_if(eq->outputs().begin(),
-                         eq->outputs().end(),
-                         std::back_inserter(outputs),
-                         [&](auto x) { return m.has_instruction(x); });
-
-            std::sort(outputs.begin(), outputs.end(), [&](auto x, auto y) {
-                return std::distance(eq, x) < std::distance(eq, y);
-            });
-            cse_range(m, outputs);
+            m.replace_instruction(ins, it->second);
+            merged++;
+            continue;
         }
-        instructions.emplace(ins->name(), ins);
+        instructions.emplace(h, ins);
     }
+    if(enabled(MIGRAPHX_TRACE_ELIMINATE_COMMON_SUBEXPRESSION{}))
+        std::cout << "eliminate_common_subexpression: merged " << merged << " instructions"
+                  << std::endl;
 }
 
-void eliminate_common_subexpression::apply(module& m) const { cse_range(m, iterator_for(m)); }
-
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
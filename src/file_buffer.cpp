@@ -23,8 +23,16 @@
  */
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/errors.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -62,6 +70,52 @@ std::string read_string(const std::string& filename)
     return generic_read_file<std::string>(filename);
 }
 
+// Used when the file cant be mapped, the data is read into memory that is page aligned like a
+// mapping would be
+static std::shared_ptr<char> read_aligned_buffer(const std::string& filename, std::size_t& nbytes)
+{
+    constexpr std::size_t alignment = 4096;
+
+    auto data         = read_buffer(filename);
+    nbytes            = data.size();
+    auto storage      = std::make_shared<std::vector<char>>(nbytes + alignment);
+    void* ptr         = storage->data();
+    std::size_t space = storage->size();
+    std::align(alignment, nbytes, ptr, space);
+    std::copy(data.begin(), data.end(), static_cast<char*>(ptr));
+    return {storage, static_cast<char*>(ptr)};
+}
+
+std::shared_ptr<char> map_buffer(const std::string& filename, std::size_t& nbytes)
+{
+#ifdef _WIN32
+    return read_aligned_buffer(filename, nbytes);
+#else
+    int fd = open(filename.c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        MIGRAPHX_THROW("Error opening file: " + filename);
+    struct stat st = {};
+    if(fstat(fd, &st) != 0)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Error reading size of file: " + filename);
+    }
+    nbytes = st.st_size;
+    if(nbytes < 1)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Invalid size for: " + filename);
+    }
+    void* addr = mmap(nullptr, nbytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if(addr == MAP_FAILED) // NOLINT
+        return read_aligned_buffer(filename, nbytes);
+    auto size = nbytes;
+    return {static_cast<char*>(addr), [size](char* p) { munmap(p, size); }};
+#endif
+}
+
 void write_buffer(const std::string& filename, const char* buffer, std::size_t size)
 {
     std::ofstream os(filename);
@@ -0,0 +1,328 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_pointwise.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_HOST_JIT)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_HOST_JIT_COMPILER)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_HOST_JIT_CACHE_DIR)
+
+// NOLINTNEXTLINE
+static const char* const host_pointwise_preamble = R"__migraphx__(
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace migraphx_host {
+
+using std::acos;
+using std::acosh;
+using std::asin;
+using std::asinh;
+using std::atan;
+using std::atanh;
+using std::ceil;
+using std::cos;
+using std::cosh;
+using std::erf;
+using std::exp;
+using std::floor;
+using std::fmod;
+using std::isnan;
+using std::log;
+using std::pow;
+using std::remainder;
+using std::round;
+using std::sin;
+using std::sinh;
+using std::sqrt;
+using std::tan;
+using std::tanh;
+
+template <class T>
+T abs(T x)
+{
+    if constexpr(std::is_unsigned<T>{})
+        return x;
+    else
+        return std::abs(x);
+}
+
+template <class T>
+T rsqrt(T x)
+{
+    return T(1) / std::sqrt(x);
+}
+
+template <class T, class U>
+auto max(T x, U y)
+{
+    using type = std::common_type_t<T, U>;
+    return std::max<type>(x, y);
+}
+
+template <class T, class U>
+auto min(T x, U y)
+{
+    using type = std::common_type_t<T, U>;
+    return std::min<type>(x, y);
+}
+
+template <class B, class T, class U>
+auto where(B cond, T x, U y)
+{
+    using type = std::common_type_t<T, U>;
+    return cond ? type(x) : type(y);
+}
+
+template <class T, class U>
+T convert(U x)
+{
+    if constexpr(std::is_floating_point<U>{})
+    {
+        if(std::isnan(x))
+            return std::numeric_limits<T>::quiet_NaN();
+    }
+    return static_cast<T>(x);
+}
+
+} // namespace migraphx_host
+
+)__migraphx__";
+
+static bool is_host_type(const shape& s)
+{
+    if(s.dynamic() or s.type() == shape::tuple_type or s.type() == shape::half_type)
+        return false;
+    return true;
+}
+
+// Index into an argument for the i-th element of the output in standard order
+static std::string host_index(const shape& s)
+{
+    if(s.elements() == 1)
+        return "0";
+    if(s.standard())
+        return "i";
+    std::vector<std::string> terms;
+    auto standard_strides = shape{s.type(), s.lens()}.strides();
+    for(std::size_t d = 0; d < s.ndim(); d++)
+    {
+        if(s.strides()[d] == 0 or s.lens()[d] == 1)
+            continue;
+        terms.push_back("((i / " + std::to_string(standard_strides[d]) + ") % " +
+                        std::to_string(s.lens()[d]) + ") * " + std::to_string(s.strides()[d]));
+    }
+    if(terms.empty())
+        return "0";
+    return join_strings(terms, " + ");
+}
+
+static std::string generate_host_pointwise(const module& m,
+                                           const shape& output,
+                                           const std::vector<shape>& inputs)
+{
+    cpp_generator g;
+    g.fmap([](const std::string& name) { return "migraphx_host::" + name; });
+    g.fresult([](const shape& s) { return "static_cast<" + shape::cpp_type(s.type()) + ">"; });
+    auto f     = g.generate_module(m).set_attributes({"static", "inline"});
+    f.name     = "pointwise_function";
+    auto fname = g.create_function(f);
+
+    // When all the tensors share one packed layout the loop walks memory
+    // directly, otherwise each tensor computes its offset from the output index
+    bool same_layout = output.packed() and all_of(inputs, [&](const shape& s) {
+                           return s.elements() == 1 or s.strides() == output.strides();
+                       });
+    auto index = [&](const shape& s) {
+        if(s.elements() == 1)
+            return std::string{"0"};
+        if(same_layout)
+            return std::string{"i"};
+        return host_index(s);
+    };
+
+    std::stringstream ss;
+    ss << host_pointwise_preamble << g.str() << "\n";
+    ss << "extern \"C\" void pointwise_kernel(void* output, const void* const* inputs, "
+          "std::size_t start, std::size_t last)\n{\n";
+    ss << "    auto* __restrict y = static_cast<" << shape::cpp_type(output.type())
+       << "*>(output);\n";
+    std::vector<std::string> args;
+    for(std::size_t k = 0; k < inputs.size(); k++)
+    {
+        auto x = "x" + std::to_string(k);
+        ss << "    const auto* __restrict " << x << " = static_cast<const "
+           << shape::cpp_type(inputs[k].type()) << "*>(inputs[" << k << "]);\n";
+        args.push_back(x + "[" + index(inputs[k]) + "]");
+    }
+    ss << "    for(std::size_t i = start; i < last; i++)\n";
+    ss << "        y[" << index(output) << "] = " << fname << "(" << join_strings(args, ", ")
+       << ");\n";
+    ss << "}\n";
+    return ss.str();
+}
+
+// Compiles the source to a shared object. When MIGRAPHX_HOST_JIT_CACHE_DIR is set the object is
+// saved there along with the compile command and source, and is reused by later processes that
+// compile the same source.
+static dynamic_loader compile_shared_object(const std::string& src)
+{
+    src_compiler compiler;
+    auto cxx = string_value_of(MIGRAPHX_HOST_JIT_COMPILER{});
+    if(not cxx.empty())
+        compiler.compiler = cxx;
+    compiler.flags  = "-std=c++17 -O3 -march=native -fPIC -shared ";
+    compiler.output = "libpointwise.so";
+    src_file file;
+    file.path    = "pointwise.cpp";
+    file.content = std::make_pair(src.data(), src.data() + src.size());
+
+    auto dir = string_value_of(MIGRAPHX_HOST_JIT_CACHE_DIR{});
+    if(dir.empty())
+        return dynamic_loader{compiler.compile({file})};
+    auto description = "// " + compiler.compiler + " " + compiler.flags + "\n" + src;
+    std::stringstream ss;
+    ss << "pointwise-" << std::hex << std::setw(16) << std::setfill('0')
+       << std::hash<std::string>{}(description);
+    auto base = fs::path{dir} / ss.str();
+    auto so   = fs::path{base.string() + ".so"};
+    auto cpp  = fs::path{base.string() + ".cpp"};
+    std::error_code ec;
+    // The source is written last, so a matching source means the object is complete
+    if(fs::exists(cpp, ec) and fs::exists(so, ec) and read_string(cpp.string()) == description)
+        return dynamic_loader{so};
+    auto binary = compiler.compile({file});
+    try
+    {
+        fs::create_directories(dir, ec);
+        auto tmp = fs::path{dir} / unique_string(ss.str() + ".tmp");
+        write_buffer(tmp.string(), binary);
+        fs::rename(tmp, so);
+        write_buffer(tmp.string(), description.data(), description.size());
+        fs::rename(tmp, cpp);
+    }
+    catch(const std::exception&)
+    {
+        // A cache that can't be written to only costs compiling again
+    }
+    return dynamic_loader{binary};
+}
+
+static host_pointwise_kernel load_host_pointwise(const std::string& src)
+{
+    auto kernel = compile_shared_object(src)
+                      .get_function<void(void*, const void* const*, std::size_t, std::size_t)>(
+                          "pointwise_kernel");
+    return [=](const argument& output, const std::vector<argument>& inputs) {
+        std::vector<const void*> ptrs(inputs.size());
+        std::transform(inputs.begin(), inputs.end(), ptrs.begin(), [](const argument& a) {
+            return static_cast<const void*>(a.data());
+        });
+        const std::size_t block = 8192;
+        auto n                  = output.get_shape().elements();
+        par_for((n + block - 1) / block, [&](auto b) {
+            kernel(output.data(), ptrs.data(), b * block, std::min(n, (b + 1) * block));
+        });
+    };
+}
+
+host_pointwise_kernel
+compile_host_pointwise(const module& m, const shape& output, const std::vector<shape>& inputs)
+{
+    const bool trace = enabled(MIGRAPHX_TRACE_HOST_JIT{});
+    if(not is_host_type(output) or not all_of(inputs, &is_host_type))
+        return nullptr;
+    if(not all_of(iterator_for(m), [](auto ins) {
+           return ins->name() == "@return" or is_host_type(ins->get_shape());
+       }))
+        return nullptr;
+    std::string src;
+    try
+    {
+        src = generate_host_pointwise(m, output, inputs);
+    }
+    catch(const std::exception& e)
+    {
+        // An operator without a point_op can't be generated
+        if(trace)
+            std::cout << "Host JIT: cannot generate " << m.name() << ": " << e.what()
+                      << std::endl;
+        return nullptr;
+    }
+
+    // Modules that generate the same source share one kernel in the process, and a failure is
+    // only reported the first time
+    static std::mutex mutex;
+    static std::unordered_map<std::string, host_pointwise_kernel> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(src);
+    if(it != cache.end())
+        return it->second;
+    host_pointwise_kernel kernel = nullptr;
+    try
+    {
+        kernel = load_host_pointwise(src);
+    }
+    catch(const std::exception& e)
+    {
+        if(trace)
+        {
+            std::cout << "Host JIT: failed to compile " << m.name() << ": " << e.what()
+                      << std::endl;
+            std::cout << src << std::endl;
+        }
+    }
+    cache.emplace(src, kernel);
+    return kernel;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
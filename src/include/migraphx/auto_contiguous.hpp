@@ -37,6 +37,7 @@ struct MIGRAPHX_EXPORT auto_contiguous
 {
     std::string name() const { return "auto_contiguous"; }
     void apply(module& m) const;
+    bool is_module_local() const { return true; }
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,80 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_BATCH_QUEUE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_BATCH_QUEUE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/argument.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct batch_queue_impl;
+
+struct MIGRAPHX_EXPORT batch_queue_options
+{
+    /// The most samples to run together. When zero, this is the largest batch
+    /// the program accepts.
+    std::size_t max_batch = 0;
+    /// How long a request waits for others to join its batch
+    std::chrono::microseconds timeout{1000};
+};
+
+using batch_result = std::shared_future<std::vector<argument>>;
+
+/**
+ * Coalesces requests into batches and runs them on a worker thread.
+ *
+ * The first dimension of every parameter and every output is the batch
+ * dimension. Requests are concatenated along it until the batch is full or
+ * the oldest request has waited for the timeout, and the outputs are split
+ * back along it. A program with a fixed batch has its inputs padded up to
+ * that batch, while a program with a dynamic batch runs with just the
+ * samples that were queued.
+ *
+ * Copies of a batch_queue share the same queue, and the worker finishes the
+ * queued requests once the last copy is destroyed.
+ */
+struct MIGRAPHX_EXPORT batch_queue
+{
+    batch_queue(program p, batch_queue_options options = {});
+
+    /// Queue a request whose parameters each hold one or more samples
+    batch_result submit(parameter_map params) const;
+
+    std::size_t max_batch() const;
+
+    private:
+    std::shared_ptr<batch_queue_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
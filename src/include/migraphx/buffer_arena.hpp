@@ -0,0 +1,98 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_BUFFER_ARENA_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_BUFFER_ARENA_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct buffer_arena_stats
+{
+    // Number of buffers handed out by the arena
+    std::size_t allocations = 0;
+    // Number of buffers that had to be allocated from the heap
+    std::size_t heap_allocations = 0;
+    // Bytes owned by the arena, whether in use or free
+    std::size_t reserved_bytes = 0;
+    // Bytes kept in the free lists for reuse
+    std::size_t free_bytes = 0;
+};
+
+/**
+ * Host memory that is recycled by size class. A buffer is returned to the
+ * arena when its last shared_ptr is released and handed out again for the
+ * next allocation in the same class. Returned buffers are only kept while
+ * the free lists hold less than max_free_bytes, and they are all freed once
+ * the last copy of the arena is destroyed. After the first evaluation of a
+ * program all of its intermediate results come from recycled buffers.
+ * Copies of the arena share the same memory.
+ */
+struct MIGRAPHX_EXPORT buffer_arena
+{
+    explicit buffer_arena(std::size_t max_free_bytes = std::size_t{1} << 30);
+
+    /// Get a buffer of at least n bytes, where the first n bytes are zero when zero is set
+    std::shared_ptr<char> allocate(std::size_t n, bool zero = true) const;
+
+    /// Free the buffers that are not in use
+    void release() const;
+
+    buffer_arena_stats get_stats() const;
+
+    private:
+    struct impl;
+    std::shared_ptr<impl> pimpl;
+    std::shared_ptr<void> owner;
+};
+
+/// Allocate a buffer from the arena in scope, or a zero-initialized buffer from the heap
+MIGRAPHX_EXPORT std::shared_ptr<char> allocate_host_buffer(std::size_t n);
+
+/**
+ * While this is alive, arguments constructed from a shape on the current
+ * thread take their buffer from the arena. Operators that write every
+ * element of their results can skip zeroing recycled buffers.
+ */
+struct MIGRAPHX_EXPORT buffer_arena_scope
+{
+    explicit buffer_arena_scope(const buffer_arena& a, bool zero = true);
+    buffer_arena_scope(const buffer_arena_scope&) = delete;
+    buffer_arena_scope& operator=(const buffer_arena_scope&) = delete;
+    ~buffer_arena_scope();
+
+    private:
+    friend std::shared_ptr<char> allocate_host_buffer(std::size_t n);
+    const buffer_arena* arena;
+    bool zero_init;
+    const buffer_arena_scope* previous;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_CALIBRATION_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_CALIBRATION_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// How the clipping threshold of a tensor is chosen from its calibration histogram
+enum class calibration_method
+{
+    max_abs,
+    percentile,
+    entropy
+};
+
+struct calibration_options
+{
+    calibration_method method = calibration_method::max_abs;
+    /// Percentage of the values that are kept unclipped with the percentile method
+    double percentile = 99.99;
+    std::size_t bins  = 2048;
+    /// Quantize constant convolution and dot weights with a scale for each output channel
+    bool per_channel_weights = false;
+};
+
+/**
+ * Streaming histogram of the absolute values of the tensors captured for one
+ * input. The range of the histogram is always a power of two, so when a larger
+ * value is seen the existing bins are merged in groups instead of rebinning
+ * the data, and histograms with different ranges can be combined exactly.
+ */
+struct MIGRAPHX_EXPORT calibration_histogram
+{
+    std::vector<std::uint64_t> counts;
+    float range   = 0;
+    float max_abs = 0;
+
+    explicit calibration_histogram(std::size_t bins = 2048);
+
+    /// Adds the values of arg in one parallel pass, each chunk is binned
+    /// separately and then merged
+    void add(const argument& arg);
+
+    void merge(const calibration_histogram& h);
+
+    std::uint64_t total() const;
+
+    /// Clipping threshold for the absolute values
+    float threshold(const calibration_options& options) const;
+
+    /// The int8 scale and shift pair used by quantize_int8_pass
+    std::pair<float, float> quant_params(const calibration_options& options) const;
+
+    private:
+    void grow(float r);
+    float percentile_threshold(double p) const;
+    float entropy_threshold() const;
+};
+
+/// Saves the int8 scale and shift of each captured input as json
+MIGRAPHX_EXPORT void save_calibration(const std::vector<std::pair<float, float>>& quant_params,
+                                      const std::string& filename);
+
+MIGRAPHX_EXPORT std::vector<std::pair<float, float>> load_calibration(const std::string& filename);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_CALIBRATION_HPP
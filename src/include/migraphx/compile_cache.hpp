@@ -0,0 +1,80 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Stores compiled programs as mxr files in a directory. An entry is described by the uncompiled
+ * program, the target and its context, the compile options, the MIGRAPHX_* environment variables
+ * that are set and the MIGraphX version, and is named by a hash of that description. The full description is stored next to the mxr file and checked
+ * on load, so a hash collision is a miss rather than the wrong program. The least recently used
+ * files are removed once the directory grows past max_size bytes.
+ */
+struct MIGRAPHX_EXPORT compile_cache
+{
+    fs::path directory;
+    std::size_t max_size = 0;
+
+    compile_cache(fs::path dir, std::size_t max_bytes);
+
+    /// Returns the cache set by MIGRAPHX_COMPILE_CACHE_DIR, if any
+    static optional<compile_cache> from_env();
+
+    /// Describes compiling p, which must not be compiled yet, with the context ctx from t
+    static value describe(const program& p,
+                          const target& t,
+                          const context& ctx,
+                          const compile_options& options = compile_options{});
+
+    /// Computes the key an entry is stored under from its description
+    static std::string key(const value& description);
+
+    fs::path path(const std::string& key) const;
+
+    /// Loads the compiled program for the description. Unreadable entries are removed, and
+    /// entries stored for a different description are ignored.
+    optional<program> load(const value& description) const;
+
+    /// Saves the compiled program for the description and evicts old entries
+    void store(const value& description, const program& p) const;
+
+    /// Removes the least recently used entries until the cache fits in max_size
+    void evict() const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
@@ -29,13 +29,20 @@
 #include <migraphx/par_for.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Naive convolution that computes each output element independently. This
+// supports any layout and is used to verify the direct convolution.
 template <class Output, class T, class Padding, class Stride>
-void convolution(Output output, T input, T weights, Padding padding, Stride stride, int group)
+void convolution_reference(
+    Output output, T input, T weights, Padding padding, Stride stride, int group)
 {
     auto output_shape = output.get_shape();
     auto in_lens      = input.get_shape().lens();
@@ -45,8 +52,7 @@ void convolution(Output output, T input, T weights, Padding padding, Stride stri
     auto wei_c    = wei_lens[1];
     std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
 
-    par_for(output_shape.elements(), [&](auto i) {
-        auto idx_o = output_shape.multi(i);
+    par_shape_for_each(output_shape, [&](const auto& idx_o, auto i) {
         auto w     = idx_o[1];
         auto n_dim = idx_o.size();
 
@@ -62,18 +68,18 @@ void convolution(Output output, T input, T weights, Padding padding, Stride stri
         shape win_shape{output_shape.type(), win_size};
 
         double acc = 0.0;
+        std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
+        std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
+        idx_wei[0] = w;
         shape_for_each(win_shape, [&](const auto& idx_win) {
             auto k           = idx_win[0];
             const auto in_ch = group_id * wei_c + k;
-            std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-            idx[1] = in_ch;
+            idx[1]           = in_ch;
             std::transform(idx_win.begin() + 1,
                            idx_win.end(),
                            win_start.begin(),
                            idx.begin() + 2,
                            [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-            std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-            idx_wei[0] = w;
             std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
             if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
                std::equal(idx.begin(),
@@ -90,6 +96,126 @@ void convolution(Output output, T input, T weights, Padding padding, Stride stri
     });
 }
 
+template <class T>
+using convolution_accumulator = std::conditional_t<std::is_integral<T>{}, std::int64_t, double>;
+
+// Direct convolution over packed tensors. The 1d and 2d cases are treated as
+// 3d with unit leading spatial dimensions. Each task computes one output row,
+// where the padding is handled by computing the valid range of the row up front
+// so the inner loop over the row has no bounds checks.
+template <class Output, class T, class Padding, class Stride>
+void direct_convolution(
+    Output output, T input, T weights, Padding padding, Stride stride, int group)
+{
+    using acc_type      = convolution_accumulator<typename Output::value_type>;
+    const auto& in_lens = input.get_shape().lens();
+    const auto& w_lens  = weights.get_shape().lens();
+    const auto& o_lens  = output.get_shape().lens();
+    const std::size_t kdims = in_lens.size() - 2;
+
+    std::array<std::size_t, 3> in_dims{1, 1, 1};
+    std::array<std::size_t, 3> out_dims{1, 1, 1};
+    std::array<std::size_t, 3> win_dims{1, 1, 1};
+    std::array<std::ptrdiff_t, 3> pads{0, 0, 0};
+    std::array<std::ptrdiff_t, 3> strides{1, 1, 1};
+    for(std::size_t d = 0; d < kdims; d++)
+    {
+        auto j      = 3 - kdims + d;
+        in_dims[j]  = in_lens[d + 2];
+        out_dims[j] = o_lens[d + 2];
+        win_dims[j] = w_lens[d + 2];
+        pads[j]     = padding[d];
+        strides[j]  = stride[d];
+    }
+
+    const std::size_t batch       = in_lens[0];
+    const std::size_t in_channels = in_lens[1];
+    const std::size_t wei_n       = w_lens[0];
+    const std::size_t wei_c       = w_lens[1];
+    const std::size_t in_plane    = in_dims[0] * in_dims[1] * in_dims[2];
+    const std::size_t win_plane   = win_dims[0] * win_dims[1] * win_dims[2];
+    const std::size_t out_width   = out_dims[2];
+    const auto iw                 = static_cast<std::ptrdiff_t>(in_dims[2]);
+    const auto sw                 = strides[2];
+
+    const auto* in_data = input.data();
+    const auto* w_data  = weights.data();
+    auto* out_data      = output.data();
+
+    // Scratch row for each thread so no allocations are done per output
+    std::vector<std::vector<acc_type>> scratch(std::max<std::size_t>(1, get_thread_pool().size()),
+                                               std::vector<acc_type>(out_width));
+    const std::size_t rows = batch * wei_n * out_dims[0] * out_dims[1];
+    par_for(rows, 1, [&](std::size_t row, std::size_t tid) {
+        auto& acc = scratch[tid];
+        std::fill(acc.begin(), acc.end(), acc_type{0});
+
+        const std::size_t oh = row % out_dims[1];
+        const std::size_t od = (row / out_dims[1]) % out_dims[0];
+        const std::size_t oc = (row / (out_dims[1] * out_dims[0])) % wei_n;
+        const std::size_t n  = row / (out_dims[1] * out_dims[0] * wei_n);
+
+        const std::size_t group_id = oc / (wei_n / group);
+        for(std::size_t k = 0; k < wei_c; k++)
+        {
+            const std::size_t ic = group_id * wei_c + k;
+            assert(ic < in_channels);
+            const auto* in_c = in_data + (n * in_channels + ic) * in_plane;
+            const auto* w_c  = w_data + (oc * wei_c + k) * win_plane;
+            for(std::size_t kd = 0; kd < win_dims[0]; kd++)
+            {
+                auto id = static_cast<std::ptrdiff_t>(od) * strides[0] - pads[0] +
+                          static_cast<std::ptrdiff_t>(kd);
+                if(id < 0 or id >= static_cast<std::ptrdiff_t>(in_dims[0]))
+                    continue;
+                for(std::size_t kh = 0; kh < win_dims[1]; kh++)
+                {
+                    auto ih = static_cast<std::ptrdiff_t>(oh) * strides[1] - pads[1] +
+                              static_cast<std::ptrdiff_t>(kh);
+                    if(ih < 0 or ih >= static_cast<std::ptrdiff_t>(in_dims[1]))
+                        continue;
+                    const auto* in_row = in_c + (id * in_dims[1] + ih) * in_dims[2];
+                    const auto* w_row  = w_c + (kd * win_dims[1] + kh) * win_dims[2];
+                    for(std::size_t kw = 0; kw < win_dims[2]; kw++)
+                    {
+                        const acc_type w = w_row[kw];
+                        // Find the range of outputs that read inside the input row
+                        const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(kw) - pads[2];
+                        std::ptrdiff_t first        = 0;
+                        if(offset < 0)
+                            first = (-offset + sw - 1) / sw;
+                        std::ptrdiff_t last = 0;
+                        if(iw > offset)
+                            last = std::min<std::ptrdiff_t>(out_width, (iw - offset + sw - 1) / sw);
+                        if(sw == 1)
+                        {
+                            for(std::ptrdiff_t ow = first; ow < last; ow++)
+                                acc[ow] += w * static_cast<acc_type>(in_row[ow + offset]);
+                        }
+                        else
+                        {
+                            for(std::ptrdiff_t ow = first; ow < last; ow++)
+                                acc[ow] += w * static_cast<acc_type>(in_row[ow * sw + offset]);
+                        }
+                    }
+                }
+            }
+        }
+        std::copy(acc.begin(), acc.end(), out_data + row * out_width);
+    });
+}
+
+template <class Output, class T, class Padding, class Stride>
+void convolution(Output output, T input, T weights, Padding padding, Stride stride, int group)
+{
+    auto kdims = input.get_shape().lens().size() - 2;
+    if(kdims >= 1 and kdims <= 3 and output.get_shape().standard() and
+       input.get_shape().standard() and weights.get_shape().standard())
+        direct_convolution(output, input, weights, padding, stride, group);
+    else
+        convolution_reference(output, input, weights, padding, stride, group);
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
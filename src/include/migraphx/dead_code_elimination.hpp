@@ -42,8 +42,14 @@ struct MIGRAPHX_EXPORT dead_code_elimination
     std::string name() const { return "dead_code_elimination"; }
     void apply(module& m) const;
     void apply(program& p) const;
+    bool is_module_local() const { return true; }
 };
 
+/// Whether dead_code_elimination removes ins once it has no uses. Instructions with an empty
+/// shape are kept for their side effects, unless they are dynamic, builtins, identity, allocate,
+/// undefined or tuples.
+MIGRAPHX_EXPORT bool is_removable_when_unused(instruction_ref ins);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
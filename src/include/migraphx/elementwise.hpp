@@ -0,0 +1,171 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_ELEMENTWISE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_ELEMENTWISE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+namespace detail {
+
+// A broadcasted input viewed as [outer, mid, inner] over a standard output, where only the mid
+// dimension is stored contiguously in the input
+struct broadcast_block
+{
+    std::size_t outer = 1;
+    std::size_t mid   = 1;
+    std::size_t inner = 1;
+};
+
+// Check that s only varies along a contiguous range of axes that are stored in standard order,
+// such as a scalar, a bias along the last axis or a per channel value
+inline bool get_broadcast_block(const shape& s, broadcast_block& b)
+{
+    const auto& lens    = s.lens();
+    const auto& strides = s.strides();
+    auto is_stored      = [&](std::size_t i) { return lens[i] != 1 and strides[i] != 0; };
+    std::size_t n       = lens.size();
+    std::size_t first   = 0;
+    while(first < n and not is_stored(first))
+        first++;
+    if(first == n)
+    {
+        b.inner = s.elements();
+        return true;
+    }
+    std::size_t last = n - 1;
+    while(not is_stored(last))
+        last--;
+    std::size_t stride = 1;
+    for(std::size_t i = last + 1; i > first; i--)
+    {
+        if(lens[i - 1] != 1 and strides[i - 1] != stride)
+            return false;
+        stride *= lens[i - 1];
+    }
+    auto mul = [&](std::size_t start, std::size_t end) {
+        return std::accumulate(
+            lens.begin() + start, lens.begin() + end, std::size_t{1}, std::multiplies<>{});
+    };
+    b.outer = mul(0, first);
+    b.mid   = mul(first, last + 1);
+    b.inner = mul(last + 1, n);
+    return true;
+}
+
+template <class T, class U, class V, class F>
+void transform_broadcast(T* output, const U* x, const V* y, const broadcast_block& b, F f)
+{
+    for(std::size_t o = 0; o < b.outer; o++)
+    {
+        auto* out     = output + o * b.mid * b.inner;
+        const auto* a = x + o * b.mid * b.inner;
+        if(b.inner == 1)
+        {
+            for(std::size_t m = 0; m < b.mid; m++)
+                out[m] = f(a[m], y[m]);
+            continue;
+        }
+        for(std::size_t m = 0; m < b.mid; m++)
+        {
+            auto c = y[m];
+            for(std::size_t i = 0; i < b.inner; i++)
+                out[m * b.inner + i] = f(a[m * b.inner + i], c);
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * Same as std::transform over the tensor views, but inputs stored in the same packed layout as
+ * the output are read with a flat loop over raw pointers instead of computing the index of each
+ * element from its shape.
+ */
+template <class T, class U, class F>
+void transform_elements(tensor_view<T> output, tensor_view<U> input, F f)
+{
+    const auto& s = output.get_shape();
+    if(s.packed() and input.get_shape().strides() == s.strides())
+    {
+        T* out        = output.data();
+        const U* x    = input.data();
+        std::size_t n = s.elements();
+        for(std::size_t i = 0; i < n; i++)
+            out[i] = f(x[i]);
+        return;
+    }
+    std::transform(input.begin(), input.end(), output.begin(), f);
+}
+
+/**
+ * Same as std::transform over the tensor views, with flat loops over raw pointers when both inputs
+ * have the layout of the output, or when the output is standard and one input is standard and
+ * the other is broadcasted from a scalar or a contiguous block of axes.
+ */
+template <class T, class U, class V, class F>
+void transform_elements(tensor_view<T> output, tensor_view<U> x, tensor_view<V> y, F f)
+{
+    const auto& s = output.get_shape();
+    if(s.packed())
+    {
+        bool x_same = x.get_shape().strides() == s.strides();
+        bool y_same = y.get_shape().strides() == s.strides();
+        detail::broadcast_block b;
+        if(x_same and y_same)
+        {
+            T* out        = output.data();
+            const U* a    = x.data();
+            const V* c    = y.data();
+            std::size_t n = s.elements();
+            for(std::size_t i = 0; i < n; i++)
+                out[i] = f(a[i], c[i]);
+            return;
+        }
+        else if(s.standard() and x_same and detail::get_broadcast_block(y.get_shape(), b))
+        {
+            detail::transform_broadcast(output.data(), x.data(), y.data(), b, f);
+            return;
+        }
+        else if(s.standard() and y_same and detail::get_broadcast_block(x.get_shape(), b))
+        {
+            detail::transform_broadcast(
+                output.data(), y.data(), x.data(), b, [&](auto a, auto c) { return f(c, a); });
+            return;
+        }
+    }
+    std::transform(x.begin(), x.end(), y.begin(), output.begin(), f);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_ELEMENTWISE_HPP
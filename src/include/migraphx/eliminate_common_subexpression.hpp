@@ -40,6 +40,7 @@ struct MIGRAPHX_EXPORT eliminate_common_subexpression
 {
     std::string name() const { return "eliminate_common_subexpression"; }
     void apply(module& m) const;
+    bool is_module_local() const { return true; }
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -42,6 +42,7 @@ struct MIGRAPHX_EXPORT eliminate_identity
 {
     std::string name() const { return "eliminate_identity"; }
     void apply(module& m) const;
+    bool is_module_local() const { return true; }
 };
 
 } // namespace MIGRAPHX_INLINE_NS
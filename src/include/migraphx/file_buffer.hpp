@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_RTGLIB_FILE_BUFFER_HPP
 
 #include <migraphx/config.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,6 +36,11 @@ MIGRAPHX_EXPORT std::vector<char>
 read_buffer(const std::string& filename, size_t offset = 0, size_t nbytes = 0);
 MIGRAPHX_EXPORT std::string read_string(const std::string& filename);
 
+/// Maps the whole file into memory, the size of the file is stored in nbytes. Pages are copy on
+/// write so the file is never modified, and the mapping is released with the last copy of the
+/// returned pointer. Where files cant be mapped the file is read into page aligned memory instead.
+MIGRAPHX_EXPORT std::shared_ptr<char> map_buffer(const std::string& filename, std::size_t& nbytes);
+
 MIGRAPHX_EXPORT void
 write_buffer(const std::string& filename, const char* buffer, std::size_t size);
 MIGRAPHX_EXPORT void write_buffer(const std::string& filename, const std::vector<char>& buffer);
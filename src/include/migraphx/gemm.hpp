@@ -27,6 +27,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/dfor.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/tensor_view.hpp>
 
 namespace migraphx {
@@ -43,18 +44,23 @@ void gemm(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha
     assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
     assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
     assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
+    auto cs        = cmat.get_shape();
+    const auto& as = amat.get_shape();
+    const auto& bs = bmat.get_shape();
+    auto a_stride  = as.strides()[dim_1];
+    auto b_stride  = bs.strides()[dim_0];
 
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += amat(a_idx.begin(), a_idx.end()) * bmat(b_idx.begin(), b_idx.end());
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+    par_shape_for_each(cs, [&](const auto& c_idx) {
+        // The row of a and the column of b share the index of c except along k. The offsets
+        // are computed as integers first since c's index can be past the end of a or b.
+        std::size_t a_offset = as.index(c_idx) - c_idx[dim_1] * a_stride;
+        std::size_t b_offset = bs.index(c_idx) - c_idx[dim_0] * b_stride;
+        const T* a           = amat.data() + a_offset;
+        const T* b           = bmat.data() + b_offset;
+        double s             = 0.0;
+        dfor(k)([&](auto kk) { s += a[kk * a_stride] * b[kk * b_stride]; });
+        auto& c = cmat(c_idx.begin(), c_idx.end());
+        c       = alpha * s + c * beta;
     });
 }
 
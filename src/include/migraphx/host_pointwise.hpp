@@ -0,0 +1,54 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_HOST_POINTWISE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_HOST_POINTWISE_HPP
+
+#include <migraphx/config.hpp>
+#include <functional>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+struct shape;
+struct argument;
+
+using host_pointwise_kernel =
+    std::function<void(const argument& output, const std::vector<argument>& inputs)>;
+
+/// Generate a C++ loop for the pointwise module `m` specialized to the output
+/// and input shapes, compile it with the host compiler and load it. The inputs
+/// are passed in the order of the sorted parameter names. An empty function is
+/// returned when the module cannot be compiled for the host, so the caller can
+/// fall back to interpreting it. MIGRAPHX_TRACE_HOST_JIT prints why. Kernels are
+/// cached in the process by their generated source, and on disk in
+/// MIGRAPHX_HOST_JIT_CACHE_DIR when it is set.
+MIGRAPHX_EXPORT host_pointwise_kernel compile_host_pointwise(const module& m,
+                                                             const shape& output,
+                                                             const std::vector<shape>& inputs);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_HOST_POINTWISE_HPP
@@ -141,6 +141,10 @@ struct MIGRAPHX_EXPORT instruction
 
     void set_target_id(std::size_t tid);
 
+    /// A number that is different for every instruction created, so an instruction can be told
+    /// apart from one that was removed from the same address
+    std::size_t get_id() const;
+
     void debug_print() const;
 
     static void print(std::ostream& os,
@@ -179,6 +183,9 @@ struct MIGRAPHX_EXPORT instruction
     literal lit;
     bool normalized       = false;
     std::size_t target_id = 0;
+    std::size_t id        = create_id();
+
+    static std::size_t create_id();
 };
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -87,9 +87,22 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Shares the buffer without copying it, the buffer must hold at least s.bytes()
+    literal(const shape& s, std::shared_ptr<char> data) : buffer(std::move(data)), m_shape(s) {}
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
+    /// Whether both literals use the same buffer
+    bool shares_buffer(const literal& x) const { return not empty() and buffer == x.buffer; }
+
+    /// Returns a literal with a different shape that uses this buffer, s must not need more bytes
+    literal share(const shape& s) const
+    {
+        assert(s.bytes() <= m_shape.bytes());
+        return {s, buffer};
+    }
+
     /// Provides a raw pointer to the data
     const char* data() const { return this->buffer.get(); }
 
@@ -104,6 +117,9 @@ struct literal : raw_data<literal>
         return {m_shape, [b]() { return b.get(); }};
     }
 
+    /// Returns an argument that uses the buffer without copying it, it must not be written to
+    argument get_argument_view() const { return {m_shape, buffer}; }
+
     private:
     std::shared_ptr<char> buffer;
     shape m_shape;
@@ -0,0 +1,62 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_LITERAL_STORAGE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_LITERAL_STORAGE_HPP
+
+#include <migraphx/literal.hpp>
+#include <migraphx/config.hpp>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Content addressed storage for literal data. A literal whose bytes were already inserted is
+ * returned with its own shape but using the buffer of the earlier literal, so literals with the
+ * same payload only keep one buffer alive.
+ */
+struct MIGRAPHX_EXPORT literal_storage
+{
+    /// Returns a literal equal to l that uses the stored buffer with the same bytes
+    literal insert(const literal& l);
+
+    /// Number of distinct buffers stored
+    std::size_t size() const;
+
+    /// Number of bytes in the distinct buffers
+    std::size_t bytes() const;
+
+    /// Number of bytes that did not need a buffer of their own
+    std::size_t shared_bytes() const;
+
+    private:
+    std::unordered_multimap<std::size_t, literal> buffers;
+    std::size_t total_bytes = 0;
+    std::size_t saved_bytes = 0;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_LITERAL_STORAGE_HPP
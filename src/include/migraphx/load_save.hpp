@@ -34,6 +34,9 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct file_options
 {
     std::string format = "msgpack";
+    /// Map the file into memory when loading so literals reference the file instead of being
+    /// copied. Only used by load() with the msgpack format.
+    bool mmap = false;
 };
 
 MIGRAPHX_EXPORT program load(const std::string& filename,
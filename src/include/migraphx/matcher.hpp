@@ -27,12 +27,15 @@
 #include <migraphx/functional.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/dead_code_elimination.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/optional.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/type_name.hpp>
 #include <migraphx/source_location.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/time.hpp>
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -373,10 +376,47 @@ match::matcher_result find_match(module& modl, M&& m)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES_FOR)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_VALIDATE_MATCHES)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIME_MATCHERS)
 
-/// Find matches for an instruction in the module for per section of matchers
-template <class Mod, class... Ms>
-void find_matches_for(source_location location, Mod& mod, instruction_ref ins, Ms&&... ms)
+/// Number of times each matcher was tried, how often it fired and the time spent in it
+struct matcher_stats
+{
+    struct counters
+    {
+        std::size_t attempts = 0;
+        std::size_t hits     = 0;
+        double time          = 0;
+    };
+    std::unordered_map<std::string, counters> matchers;
+    std::size_t rounds  = 0;
+    std::size_t visited = 0;
+
+    void print(std::ostream& os, const std::string& title) const
+    {
+        std::vector<std::pair<std::string, counters>> sorted(matchers.begin(), matchers.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& x, const auto& y) {
+            return x.second.time > y.second.time;
+        });
+        os << title << ": " << rounds << " rounds, " << visited << " instructions visited"
+           << std::endl;
+        for(const auto& p : sorted)
+        {
+            os << "    " << p.first << ": " << p.second.hits << "/" << p.second.attempts
+               << " hits, " << p.second.time << "ms" << std::endl;
+        }
+    }
+};
+
+/// Try the matchers on one instruction in order and apply the first one that
+/// matches. The apply is routed through `rewrite(r, apply)` so that callers can
+/// observe the instructions around the rewrite.
+template <class Mod, class F, class... Ms>
+bool match_and_apply(source_location location,
+                     Mod& mod,
+                     instruction_ref ins,
+                     matcher_stats* stats,
+                     F rewrite,
+                     Ms&&... ms)
 {
     const int trace         = value_of(MIGRAPHX_TRACE_MATCHES{});
     const bool validate     = enabled(MIGRAPHX_VALIDATE_MATCHES{});
@@ -393,9 +433,24 @@ void find_matches_for(source_location location, Mod& mod, instruction_ref ins, M
                 return;
             if(trace > 1 and trace_for)
                 std::cout << "Match: " << matcher_name << std::endl;
+            // Only read the clock when the matchers are timed
+            optional<timer> t;
+            if(stats != nullptr)
+                t.emplace();
+            auto record = [&](bool hit) {
+                if(stats == nullptr)
+                    return;
+                auto& c = stats->matchers[matcher_name];
+                c.attempts++;
+                c.hits += hit ? 1 : 0;
+                c.time += t->record<std::chrono::duration<double, std::milli>>();
+            };
             auto r = match_instruction(get_module(mod), ins, m.matcher());
             if(r.result == get_module(mod).end())
+            {
+                record(false);
                 return;
+            }
             if(trace > 0 or trace_for)
             {
                 std::cout << "Matched by " << matcher_name << std::endl;
@@ -403,7 +458,8 @@ void find_matches_for(source_location location, Mod& mod, instruction_ref ins, M
             }
             // If its already invalid dont validate it again
             bool invalidated = validate and get_module(mod).validate() != get_module(mod).end();
-            m.apply(mod, r);
+            rewrite(r, [&] { m.apply(mod, r); });
+            record(true);
             if(validate and not invalidated)
             {
                 auto invalid = get_module(mod).validate();
@@ -418,6 +474,15 @@ void find_matches_for(source_location location, Mod& mod, instruction_ref ins, M
             match = true;
         },
         ms...);
+    return match;
+}
+
+/// Find matches for an instruction in the module for per section of matchers
+template <class Mod, class... Ms>
+void find_matches_for(source_location location, Mod& mod, instruction_ref ins, Ms&&... ms)
+{
+    match_and_apply(
+        location, mod, ins, nullptr, [](const auto&, auto apply) { apply(); }, ms...);
 }
 
 /// Find matches in a module
@@ -436,6 +501,170 @@ struct find_matches
 template <class Mod, class... Ms>
 find_matches(Mod& mod, Ms&&... ms) -> find_matches<Mod, Ms...>;
 
+/// Tracks the instructions that need to be matched again after a rewrite
+struct rewrite_worklist
+{
+    rewrite_worklist(const module& m)
+    {
+        for(auto ins : iterator_for(m))
+            known[std::addressof(*ins)] = ins->get_id();
+    }
+
+    bool empty() const { return dirty.empty(); }
+
+    // Instructions that were not in the module before are marked together
+    // with their inputs, so new subgraphs are matched as a whole
+    void mark(instruction_ref ins)
+    {
+        auto* p = std::addressof(*ins);
+        if(not dirty.insert(p).second)
+            return;
+        // The address of a removed instruction can be reused by a new one, so the id is checked
+        auto it = known.find(p);
+        if(it != known.end() and it->second == ins->get_id())
+            return;
+        known[p] = ins->get_id();
+        for(auto input : ins->inputs())
+            mark(input);
+    }
+
+    // Matchers look at the uses of an instruction and at the consumers up to
+    // two levels down, so anything in that neighbourhood may now match
+    void touch(instruction_ref ins)
+    {
+        mark(ins);
+        for(auto output : ins->outputs())
+        {
+            mark(output);
+            for(auto input : output->inputs())
+                mark(input);
+            for(auto output2 : output->outputs())
+                mark(output2);
+        }
+    }
+
+    /// Collect the instructions a rewrite of `r` can affect
+    static std::vector<instruction_ref> neighbours(const matcher_result& r)
+    {
+        std::vector<instruction_ref> result = {r.result};
+        for(auto&& p : r.instructions)
+            result.push_back(p.second);
+        auto n = result.size();
+        for(std::size_t i = 0; i < n; i++)
+        {
+            result.insert(result.end(), result[i]->inputs().begin(), result[i]->inputs().end());
+        }
+        result.insert(result.end(), r.result->outputs().begin(), r.result->outputs().end());
+        return result;
+    }
+
+    void after_rewrite(const module& m, const std::vector<instruction_ref>& affected)
+    {
+        for(auto ins : affected)
+        {
+            if(not m.has_instruction(ins))
+                continue;
+            touch(ins);
+            maybe_dead.push_back(ins);
+        }
+    }
+
+    /// Remove the instructions left without uses by the rewrites, using the
+    /// same rules as dead_code_elimination
+    void remove_dead(module& m)
+    {
+        auto last       = std::prev(m.end());
+        auto candidates = std::exchange(maybe_dead, {});
+        for(auto ins : candidates)
+        {
+            if(not m.has_instruction(ins) or not is_removable_when_unused(ins))
+                continue;
+            // Like dead_code_elimination, the inputs of a removed instruction are removed once
+            // they have no uses left whatever their shape
+            fix([&](auto self, instruction_ref x) {
+                if(not m.has_instruction(x) or x == last or not x->outputs().empty() or
+                   contains({"@param", "@return"}, x->name()))
+                    return;
+                auto inputs = x->inputs();
+                known.erase(std::addressof(*x));
+                dirty.erase(std::addressof(*x));
+                m.remove_instruction(x);
+                for(auto input : inputs)
+                {
+                    if(not m.has_instruction(input))
+                        continue;
+                    touch(input);
+                    self(input);
+                }
+            })(ins);
+        }
+    }
+
+    std::unordered_set<const instruction*> take_dirty() { return std::exchange(dirty, {}); }
+
+    private:
+    std::unordered_map<const instruction*, std::size_t> known;
+    std::unordered_set<const instruction*> dirty;
+    std::vector<instruction_ref> maybe_dead;
+};
+
+/// Rewrite a module with the matchers until nothing changes. The first round
+/// visits every instruction, later rounds only revisit the instructions around
+/// the rewrites of the previous round, and dead instructions are removed
+/// between rounds. When a round finds nothing to rewrite, every instruction is
+/// visited again before stopping. At most `max_rounds` rounds are run.
+template <class Mod, class... Ms>
+struct find_matches_fixpoint
+{
+    find_matches_fixpoint(Mod& mod,
+                          std::size_t max_rounds,
+                          Ms&&... ms,
+                          source_location location = source_location::current())
+    {
+        const bool timed = enabled(MIGRAPHX_TIME_MATCHERS{});
+        auto& m          = get_module(mod);
+        rewrite_worklist worklist{m};
+        auto rewrite = [&](const matcher_result& r, auto apply) {
+            auto affected = rewrite_worklist::neighbours(r);
+            apply();
+            worklist.after_rewrite(m, affected);
+        };
+        bool sweep = true;
+        for(std::size_t round = 0; round < max_rounds; round++)
+        {
+            auto current = worklist.take_dirty();
+            for(auto ins : iterator_for(m))
+            {
+                if(not sweep and not contains(current, std::addressof(*ins)))
+                    continue;
+                stats.visited++;
+                match_and_apply(location, mod, ins, timed ? &stats : nullptr, rewrite, ms...);
+            }
+            stats.rounds++;
+            worklist.remove_dead(m);
+            if(not worklist.empty())
+            {
+                sweep = false;
+                continue;
+            }
+            if(sweep)
+                break;
+            // The worklist only covers the neighbourhood of the rewrites, so a matcher that looks
+            // further away can still match somewhere else. Visit every instruction once more
+            // before stopping.
+            sweep = true;
+        }
+        if(timed)
+            stats.print(std::cout, location.function_name());
+    }
+
+    matcher_stats stats;
+};
+
+template <class Mod, class... Ms>
+find_matches_fixpoint(Mod& mod, std::size_t max_rounds, Ms&&... ms)
+    -> find_matches_fixpoint<Mod, Ms...>;
+
 template <class M, class F>
 struct find_generic_match
 {
@@ -34,12 +34,16 @@ struct module;
 
 /**
  * Remove multiple memory allocations using graph coloring to find memory allocations that can be
- * reused.
+ * reused. With best_fit, allocations are instead placed from largest to smallest into the
+ * smallest gap left by the allocations whose lifetime intervals overlap. The cpu and gpu targets
+ * use best_fit when MIGRAPHX_ENABLE_BEST_FIT_MEMORY is set. Setting
+ * MIGRAPHX_TRACE_MEMORY_COLORING reports the scratch size against the most memory live at once.
  */
 struct MIGRAPHX_EXPORT memory_coloring
 {
     std::string allocation_op{};
-    bool verify = false;
+    bool verify   = false;
+    bool best_fit = false;
     std::string name() const { return "memory_coloring"; }
     void apply(module& m) const;
 };
@@ -72,6 +72,10 @@ struct MIGRAPHX_EXPORT module
     bool bypass() const;
     void set_bypass(bool b = true);
 
+    /// Counts the changes made to the instructions, so caches built from the module can tell
+    /// when they are stale
+    std::size_t get_changes() const;
+
     template <class... Ts, MIGRAPHX_REQUIRES(std::is_same<Ts, instruction_ref>{}...)>
     instruction_ref add_instruction(operation op, Ts... args)
     {
@@ -27,15 +27,40 @@
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <functional>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+/// Data that is written as a msgpack binary without being copied into a value first
+struct msgpack_binary_ref
+{
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+/// Binaries smaller than the alignment but at least this many bytes are still aligned to it
+constexpr std::size_t msgpack_min_alignment = 64;
+
+/// When alignment is non-zero, binaries stored in an object that are at least alignment bytes
+/// are padded so their data starts at a multiple of alignment in the output, and smaller binaries
+/// of at least msgpack_min_alignment bytes start at a multiple of msgpack_min_alignment
+MIGRAPHX_EXPORT void to_msgpack(const value& v,
+                                std::function<void(const char*, std::size_t)> writer,
+                                std::size_t alignment = 0);
+/// Same as above, but the "data" of an object stored under the key "literal" that is
+/// {"@binary": i} is written as the binary refs[i]. The refs must be used in order, other values
+/// are written unchanged.
 MIGRAPHX_EXPORT void to_msgpack(const value& v,
-                                std::function<void(const char*, std::size_t)> writer);
-MIGRAPHX_EXPORT std::vector<char> to_msgpack(const value& v);
+                                std::function<void(const char*, std::size_t)> writer,
+                                std::size_t alignment,
+                                const std::vector<msgpack_binary_ref>& refs);
+MIGRAPHX_EXPORT std::vector<char> to_msgpack(const value& v, std::size_t alignment = 0);
 MIGRAPHX_EXPORT value from_msgpack(const std::vector<char>& buffer);
 MIGRAPHX_EXPORT value from_msgpack(const char* buffer, std::size_t size);
+/// Reads the msgpack without copying binaries of at least min_size bytes. Each of them is
+/// replaced by an object with the "@offset" and "@size" of its data within the buffer.
+MIGRAPHX_EXPORT value from_msgpack_view(const char* buffer, std::size_t size, std::size_t min_size);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
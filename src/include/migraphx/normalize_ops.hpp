@@ -43,6 +43,7 @@ struct MIGRAPHX_EXPORT normalize_ops
 {
     std::string name() const { return "normalize_ops"; }
     void apply(module& m) const;
+    bool is_module_local() const { return true; }
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -122,16 +122,25 @@ struct gather
                 }
                 else
                 {
-                    auto out_lens  = data.get_shape().lens();
-                    out_lens[axis] = indices.get_shape().elements();
-                    migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-                    shape_for_each(out_comp_shape, [&](const auto& out_idx_v, size_t out_idx) {
-                        auto data_idx   = out_idx_v;
-                        auto in_index   = indices[data_idx[axis]];
+                    auto out_lens      = data.get_shape().lens();
+                    out_lens[axis]     = indices.get_shape().elements();
+                    auto data_strides  = data.get_shape().strides();
+                    auto axis_stride   = data_strides[axis];
+                    data_strides[axis] = 0;
+                    // The offset into data along the other axes is advanced as the output is
+                    // walked, so only the gathered axis is added for each element
+                    migraphx::shape out_comp_shape{
+                        data.get_shape().type(), out_lens, data_strides};
+                    shape_index it{out_comp_shape};
+                    for(std::size_t out_idx = 0; out_idx < out_comp_shape.elements();
+                        out_idx++, ++it)
+                    {
+                        auto in_index   = indices[it.multi()[axis]];
                         in_index        = (in_index < 0) ? in_index + axis_dim_size : in_index;
-                        data_idx[axis]  = in_index;
-                        output[out_idx] = data(data_idx.begin(), data_idx.end());
-                    });
+                        output[out_idx] = data.data()[it.offset() +
+                                                      static_cast<std::size_t>(in_index) *
+                                                          axis_stride];
+                    }
                 }
             });
         });
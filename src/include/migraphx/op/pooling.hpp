@@ -317,8 +317,7 @@ struct pooling
         auto in_lens = in_s.lens();
 
         // For each element of output; i.e., for each placement of pooling kernel...
-        par_for(output_shape.elements(), [&](auto i) {
-            auto idx_o = output_shape.multi(i);
+        par_shape_for_each(output_shape, [&](const auto& idx_o, auto i) {
             auto n_dim = idx_o.size();
             // starting offset of the pooling window
             std::vector<int> win_start;
@@ -364,11 +363,10 @@ struct pooling
             auto pool_size    = win_shape.elements();
             double output_val = op.template init<Type>();
 
+            // the coordinates of each element in the window
+            std::vector<std::size_t> idx = idx_o;
             // for each element in the window...
             shape_for_each(win_shape, [&](const auto& idx_w) {
-                // the coordinates of this element
-                auto idx = idx_o;
-
                 // Add the kernel location idx_w and the offset win_start, for each dimension.
                 // Negative results are cast to very large unsigned integers.
                 std::transform(idx_w.begin(),
@@ -152,27 +152,6 @@ struct reduce_op : op_name<Derived>
         }
     }
 
-    template <class T>
-    void reduce(tensor_view<T>& input,
-                shape& batch_shape,
-                std::vector<int64_t>& tuned_axes,
-                std::vector<std::size_t>& out_idx,
-                tensor_view<T>& output) const
-    {
-        using accumulator = accumulator_type<T>;
-        auto& self        = static_cast<const Derived&>(*this);
-        auto data_idx     = out_idx;
-        accumulator val   = self.init();
-        shape_for_each(batch_shape, [&](const auto& b_idx) {
-            this->tune_dims(tuned_axes, b_idx, data_idx);
-            accumulator x = input(data_idx.begin(), data_idx.end());
-            val           = self.op()(accumulator{self.input()(x)}, val);
-        });
-
-        output(out_idx.begin(), out_idx.end()) =
-            static_cast<const Derived&>(*this).output(batch_shape)(val);
-    }
-
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
@@ -181,10 +160,27 @@ struct reduce_op : op_name<Derived>
         std::vector<std::size_t> batch_lens(dyn_out.computed_shape.lens().size(), 1);
         tune_dims(tuned_axes, arg_lens, batch_lens);
         shape batch_shape{dyn_out.computed_shape.type(), batch_lens};
+        // The reduced axes of the output index are zero, so the input index of each element in a
+        // batch is the output index plus the batch index, which can be walked with the input
+        // strides
+        shape batch_input_shape{dyn_out.computed_shape.type(),
+                                batch_lens,
+                                args.front().get_shape().strides()};
         visit_all(result, args[0])([&](auto output, auto input) {
-            par_for(dyn_out.computed_shape.elements(), [&](auto i) {
-                auto out_idx = dyn_out.computed_shape.multi(i);
-                this->reduce(input, batch_shape, tuned_axes, out_idx, output);
+            using accumulator = accumulator_type<typename decltype(input)::value_type>;
+            auto& self        = static_cast<const Derived&>(*this);
+            auto batch_size   = batch_shape.elements();
+            const auto& in_s  = input.get_shape();
+            par_shape_for_each(dyn_out.computed_shape, [&](const auto& out_idx) {
+                const auto* data = input.data() + in_s.index(out_idx);
+                accumulator val  = self.init();
+                shape_index it{batch_input_shape};
+                for(std::size_t i = 0; i < batch_size; i++, ++it)
+                {
+                    accumulator x = data[it.offset()];
+                    val           = self.op()(accumulator{self.input()(x)}, val);
+                }
+                output(out_idx.begin(), out_idx.end()) = self.output(batch_shape)(val);
             });
         });
 
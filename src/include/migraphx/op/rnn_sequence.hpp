@@ -0,0 +1,352 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_OPERATORS_RNN_SEQUENCE_HPP
+#define MIGRAPHX_GUARD_OPERATORS_RNN_SEQUENCE_HPP
+
+#include <migraphx/op/common.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/streamutils.hpp>
+#include <migraphx/config.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/**
+ * Evaluates a whole rnn, gru or lstm sequence on the host, instead of unrolling it into an
+ * instruction per timestep. The input projection of every timestep is computed by one gemm before
+ * the loop over time, so only the product with the previous hidden state is left in the loop.
+ *
+ * The inputs are the sequence, w, r, bias, sequence lengths and initial hidden state, followed by
+ * the initial cell state and peephole weights for lstm, and none of them are optional. The output
+ * is a tuple of the hidden states and the last hidden state, followed by the last cell state for
+ * lstm. The activation functions of each direction are listed in the order used by rewrite_rnn.
+ */
+struct rnn_sequence
+{
+    std::string cell = "rnn";
+    std::vector<operation> actv_funcs;
+    rnn_direction direction = rnn_direction::forward;
+    int linear_before_reset = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.cell, "cell"),
+                    f(self.actv_funcs, "actv_func"),
+                    f(self.direction, "direction"),
+                    f(self.linear_before_reset, "linear_before_reset"));
+    }
+
+    std::string name() const { return "rnn_sequence"; }
+
+    bool is_gru() const { return cell == "gru"; }
+    bool is_lstm() const { return cell == "lstm"; }
+
+    // Number of gates stacked in the w and r matrices
+    std::size_t gates() const
+    {
+        if(is_lstm())
+            return 4;
+        if(is_gru())
+            return 3;
+        return 1;
+    }
+
+    // Number of activation functions used by each direction
+    std::size_t actv_count() const
+    {
+        if(is_lstm())
+            return 3;
+        if(is_gru())
+            return 2;
+        return 1;
+    }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        if(cell != "rnn" and not is_gru() and not is_lstm())
+            MIGRAPHX_THROW("RNN_SEQUENCE: unknown cell " + cell);
+        check_shapes{inputs, *this}.has(is_lstm() ? 8 : 6).standard();
+        auto lens        = inputs[0].lens();
+        auto num_dirs    = inputs[1].lens()[0];
+        auto hidden_size = inputs[2].lens()[2];
+        if(num_dirs != (direction == rnn_direction::bidirectional ? 2 : 1))
+            MIGRAPHX_THROW("RNN_SEQUENCE: num_direction does not match the direction attribute");
+        if(inputs[1].lens()[1] != gates() * hidden_size)
+            MIGRAPHX_THROW("RNN_SEQUENCE: weights do not match the hidden size");
+        if(actv_funcs.size() != num_dirs * actv_count())
+            MIGRAPHX_THROW("RNN_SEQUENCE: wrong number of activation functions");
+
+        shape hs_shape{inputs[0].type(), {lens[0], num_dirs, lens[1], hidden_size}};
+        shape last_shape{inputs[0].type(), {num_dirs, lens[1], hidden_size}};
+        if(is_lstm())
+            return shape{{hs_shape, last_shape, last_shape}};
+        return shape{{hs_shape, last_shape}};
+    }
+
+    // Applies the activation in place. The common ones are computed directly, since they are
+    // called for every gate of every timestep.
+    template <class T>
+    static std::function<void(T*, std::size_t)> make_actv(const operation& op)
+    {
+        auto apply = [](auto f) {
+            return [=](T* x, std::size_t n) {
+                std::transform(x, x + n, x, [&](T v) { return static_cast<T>(f(double(v))); });
+            };
+        };
+        if(op.name() == "sigmoid")
+            return apply([](double v) { return 1.0 / (1.0 + std::exp(-v)); });
+        if(op.name() == "tanh")
+            return apply([](double v) { return std::tanh(v); });
+        if(op.name() == "relu")
+            return apply([](double v) { return std::max(0.0, v); });
+        return [=](T* x, std::size_t n) {
+            shape s{shape::get_type<T>{}, {n}};
+            auto result = op.compute(s, {argument{s, x}});
+            result.visit([&](auto r) { std::copy(r.begin(), r.end(), x); });
+        };
+    }
+
+    // Computes y = a * transpose(b), where a has m rows and b has n rows of k elements
+    template <class T>
+    static void
+    dot_transposed(T* y, const T* a, const T* b, std::size_t m, std::size_t n, std::size_t k)
+    {
+        const std::size_t min_grain = std::max<std::size_t>(1, 16384 / std::max<std::size_t>(1, k));
+        par_for_chunks(m * n, min_grain, [&](std::size_t start, std::size_t last) {
+            for(auto i = start; i < last; i++)
+            {
+                const T* ai = a + (i / n) * k;
+                const T* bi = b + (i % n) * k;
+                double s    = 0.0;
+                for(std::size_t kk = 0; kk < k; kk++)
+                    s += double(ai[kk]) * double(bi[kk]);
+                y[i] = static_cast<T>(s);
+            }
+        });
+    }
+
+    template <class T>
+    void compute_direction(std::size_t d,
+                           const std::vector<argument>& args,
+                           const std::vector<argument>& results,
+                           const std::vector<std::size_t>& seq_lens) const
+    {
+        auto lens              = args[0].get_shape().lens();
+        std::size_t seq_len    = lens[0];
+        std::size_t batch      = lens[1];
+        std::size_t input_size = lens[2];
+        std::size_t num_dirs   = args[1].get_shape().lens()[0];
+        std::size_t hs         = args[2].get_shape().lens()[2];
+        std::size_t ng         = gates() * hs;
+        bool is_forward        = direction == rnn_direction::forward;
+        if(direction == rnn_direction::bidirectional)
+            is_forward = (d == 0);
+
+        const T* w    = args[1].cast<T>() + d * ng * input_size;
+        const T* r    = args[2].cast<T>() + d * ng * hs;
+        const T* bias = args[3].cast<T>() + d * 2 * ng;
+        const T* ih   = args[5].cast<T>() + d * batch * hs;
+        std::vector<T> h(ih, ih + batch * hs);
+        std::vector<T> c;
+        const T* pph = nullptr;
+        if(is_lstm())
+        {
+            const T* ic = args[6].cast<T>() + d * batch * hs;
+            c.assign(ic, ic + batch * hs);
+            pph = args[7].cast<T>() + d * 3 * hs;
+        }
+
+        std::vector<std::function<void(T*, std::size_t)>> actv;
+        std::transform(actv_funcs.begin() + d * actv_count(),
+                       actv_funcs.begin() + (d + 1) * actv_count(),
+                       std::back_inserter(actv),
+                       [](const operation& op) { return make_actv<T>(op); });
+
+        // Project the input of every timestep at once. The recurrent bias is folded in as well,
+        // except for the hidden gate of gru which depends on linear_before_reset.
+        std::vector<T> xw(seq_len * batch * ng);
+        dot_transposed(xw.data(), args[0].cast<T>(), w, seq_len * batch, ng, input_size);
+        std::size_t folded = is_gru() ? 2 * hs : ng;
+        for(std::size_t i = 0; i < xw.size(); i++)
+        {
+            auto j   = i % ng;
+            double x = double(xw[i]) + double(bias[j]);
+            if(j < folded)
+                x += double(bias[ng + j]);
+            xw[i] = static_cast<T>(x);
+        }
+
+        // With linear_before_reset == 0 the reset gate is applied before the product with the
+        // hidden gate weights, so that product is done separately on rh
+        bool reset_first = is_gru() and linear_before_reset == 0;
+        std::size_t nr   = reset_first ? 2 * hs : ng;
+        std::vector<T> rec(batch * nr);
+        std::vector<T> g(batch * ng);
+        std::vector<T> rh;
+        std::vector<T> rh_out;
+        if(reset_first)
+        {
+            rh.resize(batch * hs);
+            rh_out.resize(batch * hs);
+        }
+        std::vector<T> hc(hs);
+        const T* rbh = is_gru() ? bias + ng + 2 * hs : nullptr;
+        T* y         = results[0].cast<T>();
+        const T one  = static_cast<T>(1);
+
+        std::size_t max_len =
+            seq_lens.empty() ? 0 : *std::max_element(seq_lens.begin(), seq_lens.end());
+        for(std::size_t s = 0; s < max_len; s++)
+        {
+            dot_transposed(rec.data(), h.data(), r, batch, nr, hs);
+            auto timestep = [&](std::size_t b) { return is_forward ? s : seq_lens[b] - 1 - s; };
+            if(reset_first)
+            {
+                for(std::size_t b = 0; b < batch; b++)
+                {
+                    if(s >= seq_lens[b])
+                        continue;
+                    T* gb        = g.data() + b * ng;
+                    const T* xwt = xw.data() + (timestep(b) * batch + b) * ng;
+                    for(std::size_t j = 0; j < 2 * hs; j++)
+                        gb[j] = xwt[j] + rec[b * nr + j];
+                    actv[0](gb, 2 * hs);
+                    for(std::size_t j = 0; j < hs; j++)
+                        rh[b * hs + j] = gb[hs + j] * h[b * hs + j];
+                }
+                dot_transposed(rh_out.data(), rh.data(), r + 2 * hs * hs, batch, hs, hs);
+            }
+            for(std::size_t b = 0; b < batch; b++)
+            {
+                if(s >= seq_lens[b])
+                    continue;
+                auto t        = timestep(b);
+                T* gb         = g.data() + b * ng;
+                T* hb         = h.data() + b * hs;
+                const T* xwt  = xw.data() + (t * batch + b) * ng;
+                const T* recb = rec.data() + b * nr;
+                if(is_lstm())
+                {
+                    // gates are ordered as input, output, forget and cell, and the peephole
+                    // weights as input, output and forget
+                    T* cb = c.data() + b * hs;
+                    for(std::size_t j = 0; j < ng; j++)
+                        gb[j] = xwt[j] + recb[j];
+                    for(std::size_t j = 0; j < hs; j++)
+                    {
+                        gb[j] += pph[j] * cb[j];
+                        gb[2 * hs + j] += pph[2 * hs + j] * cb[j];
+                    }
+                    actv[0](gb, hs);
+                    actv[0](gb + 2 * hs, hs);
+                    actv[1](gb + 3 * hs, hs);
+                    for(std::size_t j = 0; j < hs; j++)
+                    {
+                        cb[j] = gb[2 * hs + j] * cb[j] + gb[j] * gb[3 * hs + j];
+                        gb[hs + j] += pph[hs + j] * cb[j];
+                    }
+                    actv[0](gb + hs, hs);
+                    std::copy(cb, cb + hs, hc.begin());
+                    actv[2](hc.data(), hs);
+                    for(std::size_t j = 0; j < hs; j++)
+                        hb[j] = gb[hs + j] * hc[j];
+                }
+                else if(is_gru())
+                {
+                    // gates are ordered as update, reset and hidden
+                    if(reset_first)
+                    {
+                        for(std::size_t j = 0; j < hs; j++)
+                            gb[2 * hs + j] = xwt[2 * hs + j] + rh_out[b * hs + j] + rbh[j];
+                    }
+                    else
+                    {
+                        for(std::size_t j = 0; j < 2 * hs; j++)
+                            gb[j] = xwt[j] + recb[j];
+                        actv[0](gb, 2 * hs);
+                        for(std::size_t j = 0; j < hs; j++)
+                            gb[2 * hs + j] =
+                                xwt[2 * hs + j] + gb[hs + j] * (recb[2 * hs + j] + rbh[j]);
+                    }
+                    actv[1](gb + 2 * hs, hs);
+                    for(std::size_t j = 0; j < hs; j++)
+                        hb[j] = (one - gb[j]) * gb[2 * hs + j] + gb[j] * hb[j];
+                }
+                else
+                {
+                    for(std::size_t j = 0; j < hs; j++)
+                        gb[j] = xwt[j] + recb[j];
+                    actv[0](gb, hs);
+                    std::copy(gb, gb + hs, hb);
+                }
+                std::copy(hb, hb + hs, y + ((t * num_dirs + d) * batch + b) * hs);
+            }
+        }
+
+        std::copy(h.begin(), h.end(), results[1].cast<T>() + d * batch * hs);
+        if(is_lstm())
+            std::copy(c.begin(), c.end(), results[2].cast<T>() + d * batch * hs);
+    }
+
+    argument compute(const shape& output_shape, std::vector<argument> args) const
+    {
+        std::vector<argument> results;
+        std::transform(output_shape.sub_shapes().begin(),
+                       output_shape.sub_shapes().end(),
+                       std::back_inserter(results),
+                       [](const shape& s) { return argument{s}; });
+
+        // Timesteps past the length of a sequence are left as zero in the hidden states
+        auto seq_len = args[0].get_shape().lens()[0];
+        std::vector<std::size_t> seq_lens;
+        args[4].visit([&](auto sl) {
+            std::transform(sl.begin(), sl.end(), std::back_inserter(seq_lens), [&](auto l) {
+                return std::min<std::size_t>(std::max<std::int64_t>(l, 0), seq_len);
+            });
+        });
+        results[0].visit([&](auto output) {
+            using type = typename decltype(output)::value_type;
+            std::fill(output.begin(), output.end(), type(0));
+            for(std::size_t d = 0; d < args[1].get_shape().lens()[0]; d++)
+                compute_direction<type>(d, args, results, seq_lens);
+        });
+        return argument{results};
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -26,6 +26,13 @@
 
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/module.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/algorithm.hpp>
+#include <deque>
+#include <numeric>
+#include <memory>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -34,11 +41,89 @@ namespace op {
 struct select_module
 {
     shape output_dyn_shapes;
+    // Pad inputs up to the smallest submodule they fit in when no submodule
+    // matches exactly, and slice the outputs back. This copies through host
+    // memory, so only the ref target supports it.
+    bool pad_to_bucket = false;
+
+    /// A submodule with its sorted parameter names and shapes
+    struct dispatch_entry
+    {
+        module_ref mod;
+        std::vector<std::string> input_names;
+        std::vector<shape> input_shapes;
+        std::vector<std::string> output_names;
+        std::vector<shape> output_shapes;
+    };
+
+    /// Maps the signature of the input shapes to the submodules
+    struct dispatch_table
+    {
+        std::vector<module_ref> modules;
+        // The change count of each submodule when the table was built
+        std::vector<std::size_t> changes;
+        std::vector<dispatch_entry> entries;
+        std::unordered_multimap<std::size_t, std::size_t> lookup;
+        // Set when all submodules take the same number of inputs, otherwise
+        // the entries are searched in order
+        bool keyed = true;
+
+        bool is_current(const std::vector<module_ref>& submodule_list) const
+        {
+            return modules == submodule_list and
+                   std::equal(modules.begin(),
+                              modules.end(),
+                              changes.begin(),
+                              [](module_ref m, std::size_t n) { return m->get_changes() == n; });
+        }
+    };
+
+    /// Parameter maps reused across calls on a thread, one for each level of
+    /// nested select_module so an inner dispatch does not clobber an outer one
+    struct parameter_map_scope
+    {
+        static std::deque<std::unordered_map<std::string, argument>>& maps()
+        {
+            thread_local std::deque<std::unordered_map<std::string, argument>> result;
+            return result;
+        }
+
+        static std::size_t& depth()
+        {
+            thread_local std::size_t result = 0;
+            return result;
+        }
+
+        std::unordered_map<std::string, argument>* params;
+
+        parameter_map_scope()
+        {
+            if(depth() == maps().size())
+                maps().emplace_back();
+            params = &maps()[depth()++];
+        }
+
+        parameter_map_scope(const parameter_map_scope&)            = delete;
+        parameter_map_scope& operator=(const parameter_map_scope&) = delete;
+
+        // Release the arguments but keep the nodes, names not used by the
+        // next submodule are ignored by eval
+        ~parameter_map_scope()
+        {
+            for(auto& p : *params)
+                p.second = argument{};
+            depth()--;
+        }
+    };
+
+    // Built in finalize, and rebuilt per call if the submodules change afterwards
+    std::shared_ptr<const dispatch_table> table = nullptr;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
     {
-        return pack(f(self.output_dyn_shapes, "output_dyn_shapes"));
+        return pack(f(self.output_dyn_shapes, "output_dyn_shapes"),
+                    f(self.pad_to_bucket, "pad_to_bucket"));
     }
 
     std::string name() const { return "select_module"; }
@@ -74,6 +159,222 @@ struct select_module
         return ret;
     }
 
+    template <class F>
+    static std::size_t signature(std::size_t n, F get_shape)
+    {
+        std::size_t seed = n;
+        for(std::size_t i = 0; i < n; i++)
+        {
+            const shape& s = get_shape(i);
+            hash_combine(seed, static_cast<std::size_t>(s.type()));
+            for(auto len : s.lens())
+                hash_combine(seed, len);
+            for(auto stride : s.strides())
+                hash_combine(seed, stride);
+        }
+        return seed;
+    }
+
+    std::shared_ptr<const dispatch_table>
+    make_dispatch_table(const std::vector<module_ref>& submodule_list) const
+    {
+        auto result     = std::make_shared<dispatch_table>();
+        result->modules = submodule_list;
+        std::transform(submodule_list.begin(),
+                       submodule_list.end(),
+                       std::back_inserter(result->changes),
+                       [](module_ref m) { return m->get_changes(); });
+        for(auto* mr : submodule_list)
+        {
+            dispatch_entry e;
+            e.mod             = mr;
+            e.input_names     = get_input_parameter_names(mr);
+            e.output_names    = get_output_parameter_names(mr);
+            auto param_shapes = mr->get_parameter_shapes();
+            auto get_shape    = [&](const std::string& name) { return param_shapes.at(name); };
+            std::transform(e.input_names.begin(),
+                           e.input_names.end(),
+                           std::back_inserter(e.input_shapes),
+                           get_shape);
+            std::transform(e.output_names.begin(),
+                           e.output_names.end(),
+                           std::back_inserter(e.output_shapes),
+                           get_shape);
+            if(not result->entries.empty() and
+               result->entries.front().input_names.size() != e.input_names.size())
+                result->keyed = false;
+            auto key = signature(e.input_shapes.size(),
+                                 [&](std::size_t i) -> const shape& { return e.input_shapes[i]; });
+            result->lookup.emplace(key, result->entries.size());
+            result->entries.push_back(std::move(e));
+        }
+        return result;
+    }
+
+    static bool matches(const dispatch_entry& e, const std::vector<argument>& args)
+    {
+        assert(e.input_shapes.size() <= args.size());
+        return std::equal(e.input_shapes.begin(),
+                          e.input_shapes.end(),
+                          args.begin(),
+                          [](const shape& s, const argument& a) { return a.get_shape() == s; });
+    }
+
+    const dispatch_entry* find_entry(const dispatch_table& table,
+                                     const std::vector<argument>& args) const
+    {
+        if(table.keyed and not table.entries.empty())
+        {
+            auto n = table.entries.front().input_shapes.size();
+            if(n > args.size())
+                return nullptr;
+            auto key =
+                signature(n, [&](std::size_t i) -> const shape& { return args[i].get_shape(); });
+            auto range = table.lookup.equal_range(key);
+            for(auto it = range.first; it != range.second; ++it)
+            {
+                if(matches(table.entries[it->second], args))
+                    return &table.entries[it->second];
+            }
+            return nullptr;
+        }
+        auto it = std::find_if(table.entries.begin(), table.entries.end(), [&](const auto& e) {
+            return matches(e, args);
+        });
+        if(it == table.entries.end())
+            return nullptr;
+        return &*it;
+    }
+
+    // True when every input fits in the submodule parameter, so it can be padded to it
+    static bool fits(const dispatch_entry& e, const std::vector<argument>& args)
+    {
+        return std::equal(e.input_shapes.begin(),
+                          e.input_shapes.end(),
+                          args.begin(),
+                          [](const shape& s, const argument& a) {
+                              const auto& as = a.get_shape();
+                              if(as == s)
+                                  return true;
+                              return as.type() == s.type() and as.ndim() == s.ndim() and
+                                     std::equal(as.lens().begin(),
+                                                as.lens().end(),
+                                                s.lens().begin(),
+                                                std::less_equal<>{});
+                          });
+    }
+
+    static const dispatch_entry* find_bucket(const dispatch_table& table,
+                                             const std::vector<argument>& args)
+    {
+        const dispatch_entry* result = nullptr;
+        std::size_t elements         = 0;
+        for(const auto& e : table.entries)
+        {
+            if(e.input_shapes.size() > args.size() or not fits(e, args))
+                continue;
+            auto n = transform_accumulate(e.input_shapes.begin(),
+                                          e.input_shapes.end(),
+                                          std::size_t{0},
+                                          std::plus<>{},
+                                          [](const shape& s) { return s.elements(); });
+            if(result == nullptr or n < elements)
+            {
+                result   = &e;
+                elements = n;
+            }
+        }
+        return result;
+    }
+
+    // Copy rows of a standard buffer into rows of a different length, zero filling the rest
+    static void copy_rows(
+        char* output, std::size_t out_row, const char* input, std::size_t in_row, std::size_t rows)
+    {
+        auto n = std::min(in_row, out_row);
+        for(std::size_t i = 0; i < rows; i++)
+        {
+            auto* out = output + i * out_row;
+            std::copy(input + i * in_row, input + i * in_row + n, out);
+            std::fill(out + n, out + out_row, 0);
+        }
+    }
+
+    // The number of rows above `axis`, which are copied whole
+    static std::size_t outer_rows(const std::vector<std::size_t>& lens, std::size_t axis)
+    {
+        return std::accumulate(
+            lens.begin(), lens.begin() + axis, std::size_t{1}, std::multiplies<>{});
+    }
+
+    static argument pad_argument(const argument& a, const shape& s)
+    {
+        const auto& as = a.get_shape();
+        argument result{s};
+        auto lens = as.lens();
+        auto it   = std::mismatch(lens.begin(), lens.end(), s.lens().begin()).first;
+        auto axis = std::distance(lens.begin(), it);
+        if(as.standard() and std::equal(it + 1, lens.end(), s.lens().begin() + axis + 1))
+        {
+            auto rows = outer_rows(lens, axis);
+            copy_rows(result.data(), s.bytes() / rows, a.data(), as.bytes() / rows, rows);
+            return result;
+        }
+        std::fill(result.data(), result.data() + s.bytes(), 0);
+        visit_all(result, a)([&](auto output, auto input) {
+            shape_for_each(input.get_shape(), [&](const auto& idx) {
+                output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
+            });
+        });
+        return result;
+    }
+
+    // Slice an output of a padded submodule back along the dynamic axis
+    argument
+    slice_result(const argument& r, std::size_t i, std::size_t bucket, std::size_t len) const
+    {
+        const auto& sub_shapes = output_dyn_shapes.sub_shapes();
+        if(i >= sub_shapes.size() or not sub_shapes[i].dynamic())
+            return r;
+        const auto& dds = sub_shapes[i].dyn_dims();
+        auto it =
+            std::find_if(dds.begin(), dds.end(), [](const auto& dd) { return not dd.is_fixed(); });
+        if(it == dds.end())
+            return r;
+        auto axis = std::distance(dds.begin(), it);
+        auto lens = r.get_shape().lens();
+        if(lens.at(axis) != bucket)
+            return r;
+        lens[axis] = len;
+        shape s{r.get_shape().type(), lens};
+        if(r.get_shape().standard())
+        {
+            // A prefix of the outer dimension is already contiguous
+            if(axis == 0)
+                return r.reshape(s);
+            argument result{s};
+            auto rows = outer_rows(lens, axis);
+            copy_rows(
+                result.data(), s.bytes() / rows, r.data(), r.get_shape().bytes() / rows, rows);
+            return result;
+        }
+        argument result{s};
+        visit_all(result, r)([&](auto output, auto input) {
+            shape_for_each(s, [&](const auto& idx) {
+                output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
+            });
+        });
+        return result;
+    }
+
+    void finalize(context&,
+                  const shape&,
+                  const std::vector<shape>&,
+                  const std::vector<module_ref>& submodule_list)
+    {
+        table = make_dispatch_table(submodule_list);
+    }
+
     argument compute(const shape&,
                      const std::vector<argument>& args,
                      const std::vector<module_ref>& submodule_list,
@@ -83,60 +384,89 @@ struct select_module
         // Find submodule with input parameter shapes exactly the same as the input instruction
         // arguments. Assuming instruction arguments are in the same order as the instruction
         // parameters.
-        auto module_iter =
-            std::find_if(submodule_list.cbegin(), submodule_list.cend(), [&](module_ref mr) {
-                auto in_param_names = get_input_parameter_names(mr);
-                auto param_shapes   = mr->get_parameter_shapes();
-                assert(in_param_names.size() <= args.size());
-                return std::equal(
-                    in_param_names.cbegin(),
-                    in_param_names.cend(),
-                    args.cbegin(),
-                    [&](auto p_name, auto a) { return a.get_shape() == param_shapes[p_name]; });
-            });
-
-        if(module_iter == submodule_list.end())
+        std::shared_ptr<const dispatch_table> fresh = nullptr;
+        const dispatch_table* current               = table.get();
+        if(current == nullptr or not current->is_current(submodule_list))
+        {
+            fresh   = make_dispatch_table(submodule_list);
+            current = fresh.get();
+        }
+        const auto* entry = find_entry(*current, args);
+        if(entry == nullptr and pad_to_bucket)
+            return compute_padded(*current, args, run);
+        if(entry == nullptr)
         {
             MIGRAPHX_THROW("SELECT_MODULE: no compatible submodules found for given input shapes");
         }
 
-        auto* module_to_run = *module_iter;
-        std::unordered_map<std::string, argument> p_map;
+        auto* module_to_run = entry->mod;
+        parameter_map_scope scope;
+        auto& p_map = *scope.params;
 
         // add input parameters to parameter_map
-        auto in_param_names = get_input_parameter_names(module_to_run);
-        assert(in_param_names.size() <= args.size());
-        std::transform(in_param_names.begin(),
-                       in_param_names.end(),
-                       args.begin(),
-                       std::inserter(p_map, p_map.end()),
-                       [&](auto&& name, auto&& a) { return std::make_pair(name, a); });
+        assert(entry->input_names.size() <= args.size());
+        for(std::size_t i = 0; i < entry->input_names.size(); i++)
+            p_map[entry->input_names[i]] = args[i];
 
         // One tuple output parameter in main module to multiple output parameters in submodule
-        auto out_param_names    = get_output_parameter_names(module_to_run);
-        auto param_shapes       = module_to_run->get_parameter_shapes();
         auto output_sub_objects = args.back().get_sub_objects();
-        assert(out_param_names.size() == output_sub_objects.size());
-        std::transform(out_param_names.begin(),
-                       out_param_names.end(),
-                       output_sub_objects.begin(),
-                       std::inserter(p_map, p_map.end()),
-                       [&](auto&& name, auto&& a) {
-                           auto ps = param_shapes.at(name);
-                           if(a.get_shape() != ps)
-                           {
-                               assert(ps.bytes() <= a.get_shape().bytes());
-                               return std::make_pair(name, a.reshape(ps));
-                           }
-                           else
-                           {
-                               return std::make_pair(name, a);
-                           }
-                       });
+        assert(entry->output_names.size() == output_sub_objects.size());
+        for(std::size_t i = 0; i < entry->output_names.size(); i++)
+        {
+            const auto& ps = entry->output_shapes[i];
+            const auto& a  = output_sub_objects[i];
+            if(a.get_shape() != ps)
+            {
+                assert(ps.bytes() <= a.get_shape().bytes());
+                p_map[entry->output_names[i]] = a.reshape(ps);
+            }
+            else
+            {
+                p_map[entry->output_names[i]] = a;
+            }
+        }
         auto results = run(module_to_run, p_map);
         return argument{results};
     }
 
+    argument compute_padded(const dispatch_table& dispatch,
+                            const std::vector<argument>& args,
+                            const std::function<std::vector<argument>(
+                                module_ref&, const std::unordered_map<std::string, argument>&)>&
+                                run) const
+    {
+        const auto* entry = find_bucket(dispatch, args);
+        if(entry == nullptr)
+        {
+            MIGRAPHX_THROW("SELECT_MODULE: no compatible submodules found for given input shapes");
+        }
+        // The bucket size and the real size along the padded axis
+        std::size_t bucket = 0;
+        std::size_t len    = 0;
+        parameter_map_scope scope;
+        auto& p_map = *scope.params;
+        for(std::size_t i = 0; i < entry->input_names.size(); i++)
+        {
+            const auto& s = entry->input_shapes[i];
+            const auto& a = args[i];
+            if(a.get_shape() == s)
+            {
+                p_map[entry->input_names[i]] = a;
+                continue;
+            }
+            auto lens = a.get_shape().lens();
+            auto it   = std::mismatch(lens.begin(), lens.end(), s.lens().begin()).first;
+            bucket    = s.lens()[it - lens.begin()];
+            len       = *it;
+            p_map[entry->input_names[i]] = pad_argument(a, s);
+        }
+        module_ref module_to_run = entry->mod;
+        auto results             = run(module_to_run, p_map);
+        for(std::size_t i = 0; i < results.size(); i++)
+            results[i] = slice_result(results[i], i, bucket, len);
+        return argument{results};
+    }
+
     std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
     {
         return shapes.size() - 1;
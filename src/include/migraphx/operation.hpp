@@ -429,20 +429,78 @@ void finalize_op(T& x, context& ctx, const shape& output_shape, const std::vecto
 }
 
 template <class T>
-auto has_finalize_op(
-    rank<1>, T& x, context& ctx, const shape& output_shape, const std::vector<shape>& input)
+auto mod_finalize_op(rank<2>,
+                     T& x,
+                     context& ctx,
+                     const shape& output_shape,
+                     const std::vector<shape>& input,
+                     const std::vector<module_ref>& mod_args)
+    -> decltype(x.finalize(auto_any_cast(ctx), output_shape, input, mod_args), void())
+{
+    x.finalize(auto_any_cast(ctx), output_shape, input, mod_args);
+}
+
+template <class T>
+auto mod_finalize_op(rank<1>,
+                     T& x,
+                     context& ctx,
+                     const shape& output_shape,
+                     const std::vector<shape>& input,
+                     const std::vector<module_ref>&)
+    -> decltype(x.finalize(auto_any_cast(ctx), output_shape, input), void())
+{
+    x.finalize(auto_any_cast(ctx), output_shape, input);
+}
+
+template <class T>
+void mod_finalize_op(
+    rank<0>, T&, context&, const shape&, const std::vector<shape>&, const std::vector<module_ref>&)
+{
+}
+
+template <class T>
+void mod_finalize_op(T& x,
+                     context& ctx,
+                     const shape& output_shape,
+                     const std::vector<shape>& input,
+                     const std::vector<module_ref>& mod_args)
+{
+    mod_finalize_op(rank<2>{}, x, ctx, output_shape, input, mod_args);
+}
+
+template <class T>
+auto has_finalize_op(rank<2>,
+                     T& x,
+                     context& ctx,
+                     const shape& output_shape,
+                     const std::vector<shape>& input,
+                     const std::vector<module_ref>& mod_args)
+    -> decltype(x.finalize(auto_any_cast(ctx), output_shape, input, mod_args), std::true_type{});
+
+template <class T>
+auto has_finalize_op(rank<1>,
+                     T& x,
+                     context& ctx,
+                     const shape& output_shape,
+                     const std::vector<shape>& input,
+                     const std::vector<module_ref>&)
     -> decltype(x.finalize(auto_any_cast(ctx), output_shape, input), std::true_type{});
 
 template <class T>
-auto has_finalize_op(rank<0>, T&, context&, const shape&, const std::vector<shape>&)
-    -> std::false_type;
+auto has_finalize_op(rank<0>,
+                     T&,
+                     context&,
+                     const shape&,
+                     const std::vector<shape>&,
+                     const std::vector<module_ref>&) -> std::false_type;
 
 template <class T>
-auto has_finalize_op(const T&) -> decltype(has_finalize_op(rank<1>{},
+auto has_finalize_op(const T&) -> decltype(has_finalize_op(rank<2>{},
                                                            std::declval<T&>(),
                                                            std::declval<context&>(),
                                                            std::declval<const shape&>(),
-                                                           std::declval<std::vector<shape>>()))
+                                                           std::declval<std::vector<shape>>(),
+                                                           std::declval<std::vector<module_ref>>()))
 {
     return {};
 }
@@ -520,6 +578,11 @@ struct MIGRAPHX_EXPORT operation
     // (optional)
     void finalize(context& ctx, const shape& output, const std::vector<shape>& input);
     // (optional)
+    void finalize(context& ctx,
+                  const shape& output,
+                  const std::vector<shape>& input,
+                  const std::vector<module_ref>& mod_args);
+    // (optional)
     shape compute_shape(const std::vector<shape>& input) const;
     // (optional)
     shape compute_shape(const std::vector<shape>& inputs,
@@ -666,6 +729,15 @@ struct operation
         (*this).private_detail_te_get_handle().finalize(ctx, output, input);
     }
 
+    void finalize(context& ctx,
+                  const shape& output,
+                  const std::vector<shape>& input,
+                  const std::vector<module_ref>& mod_args)
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        (*this).private_detail_te_get_handle().finalize(ctx, output, input, mod_args);
+    }
+
     shape compute_shape(const std::vector<shape>& input) const
     {
         assert((*this).private_detail_te_handle_mem_var);
@@ -767,6 +839,10 @@ struct operation
         compile(context& ctx, const shape& output, const std::vector<shape>& input) = 0;
         virtual void
         finalize(context& ctx, const shape& output, const std::vector<shape>& input) = 0;
+        virtual void finalize(context& ctx,
+                              const shape& output,
+                              const std::vector<shape>& input,
+                              const std::vector<module_ref>& mod_args)         = 0;
         virtual shape compute_shape(const std::vector<shape>& input) const           = 0;
         virtual shape compute_shape(const std::vector<shape>& inputs,
                                     const std::vector<module_ref>& mod_args) const   = 0;
@@ -904,6 +980,29 @@ struct operation
         detail::finalize_op(private_detail_te_self, ctx, output, input);
     }
 
+    template <class T>
+    static auto private_detail_te_default_finalize(char,
+                                                   T&& private_detail_te_self,
+                                                   context& ctx,
+                                                   const shape& output,
+                                                   const std::vector<shape>& input,
+                                                   const std::vector<module_ref>& mod_args)
+        -> decltype(private_detail_te_self.finalize(ctx, output, input, mod_args))
+    {
+        private_detail_te_self.finalize(ctx, output, input, mod_args);
+    }
+
+    template <class T>
+    static void private_detail_te_default_finalize(float,
+                                                   T&& private_detail_te_self,
+                                                   context& ctx,
+                                                   const shape& output,
+                                                   const std::vector<shape>& input,
+                                                   const std::vector<module_ref>& mod_args)
+    {
+        detail::mod_finalize_op(private_detail_te_self, ctx, output, input, mod_args);
+    }
+
     template <class T>
     static auto private_detail_te_default_compute_shape(char,
                                                         T&& private_detail_te_self,
@@ -1153,6 +1252,16 @@ struct operation
                 char(0), private_detail_te_value, ctx, output, input);
         }
 
+        void finalize(context& ctx,
+                      const shape& output,
+                      const std::vector<shape>& input,
+                      const std::vector<module_ref>& mod_args) override
+        {
+
+            private_detail_te_default_finalize(
+                char(0), private_detail_te_value, ctx, output, input, mod_args);
+        }
+
         shape compute_shape(const std::vector<shape>& input) const override
         {
 
@@ -39,7 +39,8 @@ auto par_dfor(Ts... xs)
     return [=](auto f) {
         using array_type = std::array<std::size_t, sizeof...(Ts)>;
         array_type lens  = {{static_cast<std::size_t>(xs)...}};
-        auto n = std::accumulate(lens.begin(), lens.end(), 1, std::multiplies<std::size_t>{});
+        auto n = std::accumulate(
+            lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
         const std::size_t min_grain = 8;
         if(n > 2 * min_grain)
         {
@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_PAR_FOR_HPP
 #define MIGRAPHX_GUARD_RTGLIB_PAR_FOR_HPP
 
+#include <migraphx/thread_pool.hpp>
 #include <thread>
 #include <cmath>
 #include <algorithm>
@@ -72,36 +73,25 @@ void par_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
     else
     {
-        std::vector<joinable_thread> threads(threadsize);
-// Using const here causes gcc 5 to ICE
-#if(!defined(__GNUC__) || __GNUC__ != 5)
-        const
-#endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::size_t tid  = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work, &tid] {
-            auto result = joinable_thread([=] {
-                std::size_t start = work;
-                std::size_t last  = std::min(n, work + grainsize);
+        // Split the work into more chunks than threads so faster threads can
+        // pick up the remaining work
+        const std::size_t chunks_per_thread = 4;
+        const std::size_t grainsize =
+            std::max<std::size_t>(1, n / (threadsize * chunks_per_thread));
+        get_thread_pool().parallel_for(
+            n, threadsize, grainsize, [&](std::size_t start, std::size_t last, std::size_t tid) {
                 for(std::size_t i = start; i < last; i++)
                 {
                     thread_invoke(i, tid, f);
                 }
             });
-            work += grainsize;
-            ++tid;
-            return result;
-        });
-        assert(work >= n);
     }
 }
 
 template <class F>
 void par_for(std::size_t n, std::size_t min_grain, F f)
 {
-    const auto threadsize = std::min<std::size_t>(std::thread::hardware_concurrency(),
+    const auto threadsize = std::min<std::size_t>(get_thread_pool().size(),
                                                   n / std::max<std::size_t>(1, min_grain));
     par_for_impl(n, threadsize, f);
 }
@@ -113,6 +103,36 @@ void par_for(std::size_t n, F f)
     par_for(n, min_grain, f);
 }
 
+/**
+ * Same as par_for, but f is called with a [start, last) range for each chunk
+ * of the work, so state that is expensive to set up per element can be
+ * carried across the elements of a chunk.
+ */
+template <class F>
+void par_for_chunks(std::size_t n, std::size_t min_grain, F f)
+{
+    const auto threadsize = std::min<std::size_t>(get_thread_pool().size(),
+                                                  n / std::max<std::size_t>(1, min_grain));
+    if(threadsize <= 1)
+    {
+        f(std::size_t{0}, n);
+        return;
+    }
+    const std::size_t chunks_per_thread = 4;
+    const std::size_t grainsize = std::max<std::size_t>(1, n / (threadsize * chunks_per_thread));
+    get_thread_pool().parallel_for(
+        n, threadsize, grainsize, [&](std::size_t start, std::size_t last, std::size_t) {
+            f(start, last);
+        });
+}
+
+template <class F>
+void par_for_chunks(std::size_t n, F f)
+{
+    const int min_grain = 8;
+    par_for_chunks(n, min_grain, f);
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
@@ -53,6 +53,9 @@ struct pass
     void apply(module& m) const;
     /// Run the pass on the program
     void apply(program& p) const;
+    /// Whether the pass only reads and changes the module it is applied to, so it can be applied
+    /// to independent modules at the same time
+    bool is_module_local() const;
 };
 
 #else
@@ -79,6 +82,12 @@ void module_pass_manager_apply(const T& x, module_pass_manager& mpm)
     module_pass_manager_apply(rank<1>{}, x, mpm);
 }
 
+template <class T>
+bool pass_is_module_local(const T&)
+{
+    return false;
+}
+
 } // namespace detail
 
 #ifdef TYPE_ERASED_DECLARATION
@@ -92,6 +101,8 @@ struct MIGRAPHX_EXPORT pass
     void apply(module_pass_manager& mpm) const;
     // (optional)
     void apply(program& p) const;
+    // (optional)
+    bool is_module_local() const;
 };
 
 #else
@@ -177,6 +188,12 @@ struct pass
         (*this).private_detail_te_get_handle().apply(p);
     }
 
+    bool is_module_local() const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().is_module_local();
+    }
+
     friend bool is_shared(const pass& private_detail_x, const pass& private_detail_y)
     {
         return private_detail_x.private_detail_te_handle_mem_var ==
@@ -193,6 +210,7 @@ struct pass
         virtual std::string name() const                   = 0;
         virtual void apply(module_pass_manager& mpm) const = 0;
         virtual void apply(program& p) const               = 0;
+        virtual bool is_module_local() const               = 0;
     };
 
     template <class T>
@@ -223,6 +241,19 @@ struct pass
         migraphx::nop(private_detail_te_self, p);
     }
 
+    template <class T>
+    static auto private_detail_te_default_is_module_local(char, T&& private_detail_te_self)
+        -> decltype(private_detail_te_self.is_module_local())
+    {
+        return private_detail_te_self.is_module_local();
+    }
+
+    template <class T>
+    static bool private_detail_te_default_is_module_local(float, T&& private_detail_te_self)
+    {
+        return migraphx::detail::pass_is_module_local(private_detail_te_self);
+    }
+
     template <typename PrivateDetailTypeErasedT>
     struct private_detail_te_handle_type : private_detail_te_handle_base_type
     {
@@ -265,6 +296,12 @@ struct pass
             private_detail_te_default_apply(char(0), private_detail_te_value, p);
         }
 
+        bool is_module_local() const override
+        {
+
+            return private_detail_te_default_is_module_local(char(0), private_detail_te_value);
+        }
+
         PrivateDetailTypeErasedT private_detail_te_value;
     };
 
@@ -39,6 +39,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/execution_environment.hpp>
 #include <algorithm>
+#include <functional>
 #include <iostream>
 
 namespace migraphx {
@@ -108,7 +109,11 @@ struct MIGRAPHX_EXPORT program
     void mark(const parameter_map& params, marker&& m);
 
     value to_value() const;
+    /// Converts the program to a value, using literal_to_value to convert each literal
+    value to_value(const std::function<value(const literal&)>& literal_to_value) const;
     void from_value(const value& v);
+    /// Loads the program from a value, constructing each literal with make_literal
+    void from_value(const value& v, const std::function<literal(const value&)>& make_literal);
 
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
@@ -155,6 +160,9 @@ struct MIGRAPHX_EXPORT program
     std::unique_ptr<program_impl> impl;
 };
 
+/// Returns the MIGraphX version as major.minor.patch
+MIGRAPHX_EXPORT std::string get_migraphx_version();
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
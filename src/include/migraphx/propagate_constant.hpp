@@ -39,6 +39,7 @@ struct MIGRAPHX_EXPORT propagate_constant
 {
     std::string name() const { return "propagate_constant"; }
     void apply(module& m) const;
+    bool is_module_local() const { return true; }
 };
 
 } // namespace MIGRAPHX_INLINE_NS
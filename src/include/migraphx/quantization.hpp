@@ -26,6 +26,7 @@
 
 #include <string>
 #include <vector>
+#include <migraphx/calibration.hpp>
 #include <migraphx/instruction_ref.hpp>
 #include <migraphx/operation.hpp>
 #include <migraphx/config.hpp>
@@ -45,7 +46,29 @@ MIGRAPHX_EXPORT void quantize_int8(program& prog,
                                    const target& t,
                                    const std::vector<parameter_map>& calibration,
                                    const std::vector<std::string>& ins_names = {"dot",
-                                                                                "convolution"});
+                                                                                "convolution"},
+                                   const calibration_options& options = {});
+
+/**
+ * Runs the calibration data through the program and returns the int8 scale and shift of each
+ * input of the instructions in ins_names, in the order they appear in the program. The table can
+ * be saved with save_calibration and applied later without calibrating again.
+ */
+MIGRAPHX_EXPORT std::vector<std::pair<float, float>>
+calibrate_int8(const program& prog,
+               const target& t,
+               const std::vector<parameter_map>& calibration,
+               const std::vector<std::string>& ins_names = {"dot", "convolution"},
+               const calibration_options& options        = {});
+
+/// Quantizes the program to int8 with a table computed by calibrate_int8. With
+/// per_channel_weights set in options, constant convolution and dot weights are quantized with a
+/// scale for each output channel instead.
+MIGRAPHX_EXPORT void quantize_int8(program& prog,
+                                   const std::vector<std::pair<float, float>>& quant_params,
+                                   const std::vector<std::string>& ins_names = {"dot",
+                                                                                "convolution"},
+                                   const calibration_options& options        = {});
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -55,6 +55,9 @@ struct MIGRAPHX_EXPORT quantize_int8_pass
 {
     std::vector<std::string> ins_names = {"dot", "convolution"};
     std::vector<std::pair<float, float>> quant_params;
+    /// Quantize constant convolution and dot weights with a scale for each output channel
+    /// computed from the weights, instead of the calibrated scale
+    bool per_channel_weights = false;
     std::string name() const { return "quantize_int8"; }
     void apply(module& m) const;
 };
@@ -41,10 +41,15 @@ struct module;
  */
 struct MIGRAPHX_EXPORT rewrite_rnn
 {
+    /// Replace each rnn, gru and lstm with a single rnn_sequence operator evaluated on the host,
+    /// instead of unrolling every timestep
+    bool sequence = false;
     std::string name() const { return "rewrite_rnn"; }
     void apply(module& m) const;
 
     private:
+    void apply_sequence(module& m, instruction_ref ins) const;
+
     // for vanilla rnn operators
     void apply_vanilla_rnn(module& m, instruction_ref ins) const;
     std::vector<instruction_ref> vanilla_rnn_cell(bool is_forward,
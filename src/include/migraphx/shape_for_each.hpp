@@ -26,38 +26,112 @@
 
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/par_for.hpp>
 #include <algorithm>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 /**
- * Iterates the given function over the indices from the shape in order.
+ * Walks the elements of a shape in order, keeping the multi-dimensional index
+ * and the offset from the shape's strides up to date incrementally. Moving to
+ * the next element carries into the outer dimensions as the inner ones wrap
+ * around, so there is no division or allocation per element.
+ */
+struct shape_index
+{
+    shape_index(const shape& s, std::size_t start = 0)
+        : m_lens(s.lens()), m_strides(s.strides()), m_idx(m_lens.size())
+    {
+        seek(start);
+    }
+
+    /// Move to the element at position i in the standard order
+    void seek(std::size_t i)
+    {
+        m_element = i;
+        m_offset  = 0;
+        std::fill(m_idx.begin(), m_idx.end(), 0);
+        for(std::size_t d = m_lens.size(); d > 0 and i > 0; d--)
+        {
+            m_idx[d - 1] = i % m_lens[d - 1];
+            i /= m_lens[d - 1];
+            m_offset += m_idx[d - 1] * m_strides[d - 1];
+        }
+    }
+
+    const std::vector<std::size_t>& multi() const { return m_idx; }
+
+    /// Offset of the current element computed from the strides of the shape
+    std::size_t offset() const { return m_offset; }
+
+    /// Position of the current element in the standard order
+    std::size_t element() const { return m_element; }
+
+    shape_index& operator++()
+    {
+        m_element++;
+        for(std::size_t d = m_lens.size(); d > 0; d--)
+        {
+            auto& x = m_idx[d - 1];
+            x++;
+            m_offset += m_strides[d - 1];
+            if(x < m_lens[d - 1])
+                break;
+            m_offset -= x * m_strides[d - 1];
+            x = 0;
+        }
+        return *this;
+    }
+
+    private:
+    std::vector<std::size_t> m_lens;
+    std::vector<std::size_t> m_strides;
+    std::vector<std::size_t> m_idx;
+    std::size_t m_offset  = 0;
+    std::size_t m_element = 0;
+};
+
+/**
+ * Iterates the given function over the indices from the shape in order, for
+ * the elements in the range [start, last).
  */
 template <class F>
-void shape_for_each(const migraphx::shape& s, F f)
+void shape_for_each(const migraphx::shape& s, std::size_t start, std::size_t last, F f)
 {
-    std::vector<std::size_t> indices(s.lens().size());
-    const auto& index_const_ref = indices;
-    shape ss{s.type(), s.lens()};
-    size_t max = ss.elements();
-    for(std::size_t i = 0; i < max; i++)
+    shape_index it{s, start};
+    for(std::size_t i = start; i < last; i++, ++it)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
-        if constexpr(std::is_invocable<F, decltype(index_const_ref), decltype(i)>{})
-            f(index_const_ref, i);
+        if constexpr(std::is_invocable<F, const std::vector<std::size_t>&, std::size_t>{})
+            f(it.multi(), i);
         else
-            f(index_const_ref);
+            f(it.multi());
     }
 }
 
+/**
+ * Iterates the given function over the indices from the shape in order.
+ */
+template <class F>
+void shape_for_each(const migraphx::shape& s, F f)
+{
+    shape_for_each(s, 0, s.elements(), f);
+}
+
+/**
+ * Same as shape_for_each, but the elements are split into chunks that run in
+ * parallel. Each chunk starts its index in the middle of the shape and then
+ * advances it incrementally.
+ */
+template <class F>
+void par_shape_for_each(const migraphx::shape& s, F f)
+{
+    par_for_chunks(s.elements(), [&](std::size_t start, std::size_t last) {
+        shape_for_each(s, start, last, f);
+    });
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
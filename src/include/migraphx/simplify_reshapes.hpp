@@ -41,6 +41,7 @@ struct MIGRAPHX_EXPORT simplify_reshapes
     size_t depth = 4;
     std::string name() const { return "simplify_reshapes"; }
     void apply(module& m) const;
+    bool is_module_local() const { return true; }
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -35,9 +35,23 @@ inline namespace MIGRAPHX_INLINE_NS {
 /**
  * Split dynamic dimension over submodules if exactly one dimension in the parameter list is
  * dynamic.
+ *
+ * With `bucket` set, one submodule is made per bucket instead of per dimension size. The
+ * buckets are the optimals of the dynamic dimension, or the powers of two in its range when
+ * it has none, plus the max. Inputs are padded up to the next bucket at runtime and the outputs
+ * sliced back. The pass falls back to one submodule per size unless every instruction using the
+ * dynamic parameter computes the elements along the dynamic dimension independently.
+ *
+ * The amount of padding is only known once the input shape is, so it is done by select_module
+ * when it is evaluated, on host memory, rather than by pad and slice instructions in the graph.
+ * Only the ref target supports `bucket`, and enables it with MIGRAPHX_ENABLE_DYN_DIM_BUCKETS.
+ * Other targets must run the pass without it: the gpu lowering rejects a select_module that pads
+ * to a bucket.
  */
 struct MIGRAPHX_EXPORT split_single_dyn_dim
 {
+    bool bucket = false;
+
     std::string name() const { return "split_single_dyn_dim"; }
     void apply(module_pass_manager&) const;
 };
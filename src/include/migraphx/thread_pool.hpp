@@ -0,0 +1,97 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_stats
+{
+    // Number of parallel regions dispatched into the pool
+    std::size_t regions = 0;
+    // Number of chunks executed across all regions
+    std::size_t chunks = 0;
+    // Number of tasks taken by the worker threads
+    std::size_t tasks = 0;
+    // Number of tasks a worker took from another worker's queue
+    std::size_t steals = 0;
+};
+
+/**
+ * A persistent pool of worker threads. Each worker owns a task queue and
+ * idle workers steal from the back of other workers' queues. Parallel
+ * regions are split into chunks that are claimed dynamically by the calling
+ * thread and by the workers, so the caller never waits on a chunk that has
+ * not been started.
+ */
+struct MIGRAPHX_EXPORT thread_pool
+{
+    /// Start n worker threads, optionally pinning each worker to a cpu
+    explicit thread_pool(std::size_t n, bool pin = false);
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+    /// Number of worker threads
+    std::size_t size() const;
+
+    /**
+     * Run f(start, last, tid) over [0, n) in chunks of grainsize using up
+     * to nthreads threads, where the calling thread is one of them. The tid
+     * is always less than nthreads. Blocks until every chunk has finished
+     * and rethrows the first exception thrown by f.
+     */
+    void parallel_for(std::size_t n,
+                      std::size_t nthreads,
+                      std::size_t grainsize,
+                      const std::function<void(std::size_t, std::size_t, std::size_t)>& f);
+
+    /// Push a task onto one of the worker queues
+    void submit(std::function<void()> task);
+
+    thread_pool_stats get_stats() const;
+    void reset_stats();
+
+    private:
+    struct impl;
+    std::unique_ptr<impl> pimpl;
+};
+
+/**
+ * The process-wide pool used by par_for. The number of workers defaults to
+ * the hardware concurrency and can be set with MIGRAPHX_NUM_THREADS, and
+ * MIGRAPHX_THREAD_AFFINITY pins the workers to cpus.
+ */
+MIGRAPHX_EXPORT thread_pool& get_thread_pool();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -26,10 +26,14 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
+#include <string>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+/// Returns a name starting with prefix that is unique across threads and processes
+MIGRAPHX_EXPORT std::string unique_string(const std::string& prefix);
+
 struct MIGRAPHX_EXPORT tmp_dir
 {
     fs::path path;
@@ -26,6 +26,7 @@
 #include <migraphx/erase.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/ranges.hpp>
+#include <atomic>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -354,7 +355,8 @@ argument instruction::eval(bool check_eval) const
 void instruction::finalize(context& ctx)
 {
     if(has_finalize(this->op))
-        this->op.finalize(ctx, this->get_shape(), to_shapes(this->inputs()));
+        this->op.finalize(
+            ctx, this->get_shape(), to_shapes(this->inputs()), this->module_inputs());
 }
 
 void instruction::print(std::ostream& os,
@@ -470,6 +472,14 @@ std::size_t instruction::get_target_id() const { return target_id; }
 
 void instruction::set_target_id(std::size_t tid) { this->target_id = tid; }
 
+std::size_t instruction::get_id() const { return id; }
+
+std::size_t instruction::create_id()
+{
+    static std::atomic<std::size_t> next_id{0};
+    return next_id++;
+}
+
 std::vector<shape> to_shapes(const std::vector<instruction_ref>& args)
 {
     std::vector<shape> shapes(args.size());
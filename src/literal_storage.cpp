@@ -0,0 +1,64 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/literal_storage.hpp>
+#include <migraphx/hash.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+literal literal_storage::insert(const literal& l)
+{
+    if(l.empty() or l.get_shape().type() == shape::tuple_type)
+        return l;
+    auto nbytes = l.get_shape().bytes();
+    auto h      = hash_value(std::string_view{l.data(), nbytes});
+    auto found  = range(buffers.equal_range(h));
+    auto it     = std::find_if(found.begin(), found.end(), [&](const auto& pp) {
+        const auto& x = pp.second;
+        return x.get_shape().bytes() == nbytes and
+               (x.shares_buffer(l) or std::memcmp(x.data(), l.data(), nbytes) == 0);
+    });
+    if(it != found.end())
+    {
+        if(not it->second.shares_buffer(l))
+            saved_bytes += nbytes;
+        return it->second.share(l.get_shape());
+    }
+    buffers.emplace(h, l);
+    total_bytes += nbytes;
+    return l;
+}
+
+std::size_t literal_storage::size() const { return buffers.size(); }
+
+std::size_t literal_storage::bytes() const { return total_bytes; }
+
+std::size_t literal_storage::shared_bytes() const { return saved_bytes; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
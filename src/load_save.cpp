@@ -25,52 +25,252 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/msgpack.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
 #include <fstream>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-program load(const std::string& filename, const file_options& options)
+// Literals of at least a page are written page aligned in msgpack files, so a mapped file
+// shares whole pages with them
+constexpr std::size_t literal_alignment = 4096;
+// Smaller literals are written with this alignment, which is enough to use them in place.
+// Literals that are not aligned, such as from older files, are copied.
+constexpr std::size_t mapped_alignment = msgpack_min_alignment;
+
+// Literals that share a buffer are saved once with an "id", the others only refer to it as
+// {"shape": s, "shared": id}
+struct shared_literal_writer
 {
-    return load_buffer(read_buffer(filename), options);
+    std::unordered_map<const char*, std::size_t> uses;
+    // Id and size of the saved buffers
+    std::unordered_map<const char*, std::pair<std::size_t, std::size_t>> saved;
+
+    explicit shared_literal_writer(const program& p)
+    {
+        for(const auto* m : p.get_modules())
+        {
+            for(const auto& ins : *m)
+            {
+                if(ins.name() == "@literal" and not ins.get_literal().empty())
+                    uses[ins.get_literal().data()]++;
+            }
+        }
+    }
+
+    template <class F>
+    value operator()(const literal& l, F write)
+    {
+        if(l.empty() or uses[l.data()] < 2)
+            return write(l);
+        auto nbytes = l.get_shape().bytes();
+        auto it     = saved.find(l.data());
+        if(it == saved.end())
+        {
+            auto id = saved.size();
+            saved.emplace(l.data(), std::make_pair(id, nbytes));
+            auto v  = write(l);
+            v["id"] = id;
+            return v;
+        }
+        if(nbytes > it->second.second)
+            return write(l);
+        return {{"shape", to_value(l.get_shape())}, {"shared", it->second.first}};
+    }
+};
+
+// Loads each saved buffer once and gives it to all the literals that refer to it
+struct shared_literal_reader
+{
+    std::function<literal(const value&)> make_literal;
+    std::unordered_map<std::size_t, const value*> saved;
+    std::unordered_map<std::size_t, literal> loaded;
+
+    shared_literal_reader(const value& v, std::function<literal(const value&)> f)
+        : make_literal(std::move(f))
+    {
+        if(not v.contains("modules"))
+            return;
+        for(const auto& mod : v.at("modules"))
+        {
+            for(const auto& node : mod.at("nodes"))
+            {
+                if(not node.contains("literal"))
+                    continue;
+                const auto& lv = node.at("literal");
+                if(lv.contains("id"))
+                    saved[lv.at("id").to<std::size_t>()] = &lv;
+            }
+        }
+    }
+
+    literal get(std::size_t id)
+    {
+        auto it = loaded.find(id);
+        if(it != loaded.end())
+            return it->second;
+        if(not contains(saved, id))
+            MIGRAPHX_THROW("Missing shared literal: " + std::to_string(id));
+        return loaded.emplace(id, make_literal(*saved.at(id))).first->second;
+    }
+
+    literal operator()(const value& lv)
+    {
+        if(lv.contains("shared"))
+        {
+            auto s = from_value<shape>(lv.at("shape"));
+            auto l = get(lv.at("shared").to<std::size_t>());
+            if(s.bytes() > l.get_shape().bytes())
+                MIGRAPHX_THROW("Shared literal is smaller than its shape");
+            return l.share(s);
+        }
+        if(lv.contains("id"))
+            return get(lv.at("id").to<std::size_t>());
+        return make_literal(lv);
+    }
+};
+
+static program program_from_value(const value& v,
+                                  std::function<literal(const value&)> make_literal =
+                                      [](const value& lv) { return from_value<literal>(lv); })
+{
+    program p;
+    shared_literal_reader reader{v, std::move(make_literal)};
+    p.from_value(v, [&](const value& lv) { return reader(lv); });
+    return p;
 }
-program load_buffer(const std::vector<char>& buffer, const file_options& options)
+
+static value program_to_value(const program& p,
+                              const std::function<value(const literal&)>& literal_to_value =
+                                  [](const literal& l) { return to_value(l); })
 {
-    return load_buffer(buffer.data(), buffer.size(), options);
+    shared_literal_writer writer{p};
+    return p.to_value([&](const literal& l) { return writer(l, literal_to_value); });
 }
-program load_buffer(const char* buffer, std::size_t size, const file_options& options)
+
+static bool is_mapped_binary(const value& v)
 {
-    program p;
-    if(options.format == "msgpack")
+    return v.is_object() and v.size() == 2 and v.contains("@offset") and v.contains("@size");
+}
+
+static bool is_mapped_literal(const value& v)
+{
+    return v.is_object() and v.contains("shape") and v.contains("data") and
+           is_mapped_binary(v.at("data"));
+}
+
+// Copy back the binaries that are not literal data, such as compiled code in operators
+static value copy_mapped_binaries(const value& v, const char* buffer)
+{
+    if(is_mapped_binary(v))
     {
-        p.from_value(from_msgpack(buffer, size));
+        return value::binary{buffer + v.at("@offset").to<std::size_t>(),
+                             v.at("@size").to<std::size_t>()};
     }
-    else if(options.format == "json")
+    if(v.is_array())
     {
-        p.from_value(from_json_string(buffer, size));
+        value r = value::array{};
+        for(const auto& x : v)
+            r.push_back(copy_mapped_binaries(x, buffer));
+        return r;
     }
-    else
+    if(v.is_object())
     {
-        MIGRAPHX_THROW("Unknown format: " + options.format);
+        value r = value::object{};
+        for(const auto& x : v)
+        {
+            if(x.get_key() == "literal" and is_mapped_literal(x.without_key()))
+                r[x.get_key()] = x.without_key();
+            else
+                r[x.get_key()] = copy_mapped_binaries(x.without_key(), buffer);
+        }
+        return r;
     }
-    return p;
+    return v;
+}
+
+static program load_mapped(const std::string& filename)
+{
+    std::size_t size = 0;
+    auto buffer      = map_buffer(filename, size);
+    auto v = copy_mapped_binaries(from_msgpack_view(buffer.get(), size, mapped_alignment),
+                                  buffer.get());
+    return program_from_value(v, [&](const value& lv) {
+        if(not is_mapped_literal(lv))
+            return from_value<literal>(lv);
+        auto s      = from_value<shape>(lv.at("shape"));
+        auto offset = lv.at("data").at("@offset").to<std::size_t>();
+        if(lv.at("data").at("@size").to<std::size_t>() < s.bytes())
+            MIGRAPHX_THROW("Literal data is smaller than its shape in: " + filename);
+        char* data = buffer.get() + offset;
+        // Files written without aligned literals still need to be copied
+        if(offset % mapped_alignment != 0)
+            return literal{s, data};
+        // The literal keeps the whole mapping alive
+        return literal{s, std::shared_ptr<char>(buffer, data)};
+    });
+}
+
+program load(const std::string& filename, const file_options& options)
+{
+    if(options.mmap and options.format == "msgpack")
+        return load_mapped(filename);
+    return load_buffer(read_buffer(filename), options);
+}
+program load_buffer(const std::vector<char>& buffer, const file_options& options)
+{
+    return load_buffer(buffer.data(), buffer.size(), options);
+}
+program load_buffer(const char* buffer, std::size_t size, const file_options& options)
+{
+    if(options.format == "msgpack")
+        return program_from_value(from_msgpack(buffer, size));
+    if(options.format == "json")
+        return program_from_value(from_json_string(buffer, size));
+    MIGRAPHX_THROW("Unknown format: " + options.format);
+}
+
+// Writes the program without copying the literals into the value
+static void save_msgpack(const program& p, std::function<void(const char*, std::size_t)> writer)
+{
+    std::vector<msgpack_binary_ref> refs;
+    auto v = program_to_value(p, [&](const literal& l) {
+        if(l.empty() or l.get_shape().type() == shape::tuple_type)
+            return to_value(l);
+        refs.push_back({l.data(), l.get_shape().bytes()});
+        return value{{"shape", to_value(l.get_shape())}, {"data", {{"@binary", refs.size() - 1}}}};
+    });
+    to_msgpack(v, std::move(writer), literal_alignment, refs);
 }
 
 void save(const program& p, const std::string& filename, const file_options& options)
 {
-    write_buffer(filename, save_buffer(p, options));
+    if(options.format != "msgpack")
+    {
+        write_buffer(filename, save_buffer(p, options));
+        return;
+    }
+    std::ofstream os(filename, std::ios::binary);
+    if(not os)
+        MIGRAPHX_THROW("Error opening file: " + filename);
+    save_msgpack(p, [&](const char* b, std::size_t n) { os.write(b, n); });
+    if(not os)
+        MIGRAPHX_THROW("Error writing file: " + filename);
 }
 std::vector<char> save_buffer(const program& p, const file_options& options)
 {
-    value v = p.to_value();
     std::vector<char> buffer;
     if(options.format == "msgpack")
     {
-        buffer = to_msgpack(v);
+        save_msgpack(
+            p, [&](const char* b, std::size_t n) { buffer.insert(buffer.end(), b, b + n); });
     }
     else if(options.format == "json")
     {
-        std::string s = to_json_string(v);
+        std::string s = to_json_string(program_to_value(p));
         buffer        = std::vector<char>(s.begin(), s.end());
     }
     else
@@ -32,6 +32,7 @@
 #include <migraphx/stringutils.hpp>
 #include <unordered_set>
 #include <unordered_map>
+#include <limits>
 #include <map>
 #include <set>
 
@@ -39,6 +40,7 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DEBUG_MEMORY_COLORING);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MEMORY_COLORING);
 
 using instruction_set     = std::unordered_set<instruction_ref>;
 using instruction_set_map = std::unordered_map<instruction_ref, instruction_set>;
@@ -320,57 +322,245 @@ struct allocation_segment
     }
 };
 
-static std::size_t find_max_alignment(const module& m, const std::string& allocation_op)
+// The lifetime of an allocation, as positions in the module where it is live
+struct allocation_interval
 {
-    std::size_t alignment = 1;
-    for(auto ins : iterator_for(m))
+    instruction_ref ins;
+    std::size_t start = 0;
+    std::size_t end   = 0;
+    // Size in units of the alignment
+    std::size_t size = 0;
+
+    bool overlaps(const allocation_interval& x) const
     {
+        return start <= x.end and x.start <= end;
+    }
+};
+
+// Build the lifetime intervals of the allocations. Two allocations conflict exactly when their
+// intervals overlap, since one of them is always defined while the other is live.
+static std::vector<allocation_interval>
+build_intervals(const module& m, const std::string& allocation_op, std::size_t alignment)
+{
+    std::unordered_map<instruction_ref, std::size_t> positions;
+    std::size_t i = 0;
+    for(auto ins : iterator_for(m))
+        positions[ins] = i++;
+    std::unordered_map<instruction_ref, std::size_t> last_live;
+    std::vector<allocation_interval> result;
+    liveness(m, [&](auto ins, const auto& live_set) {
+        auto pos = positions.at(ins);
+        for(auto live : live_set)
+        {
+            if(live->name() != allocation_op)
+                continue;
+            auto& last = last_live[live];
+            last       = std::max(last, pos);
+        }
+        // Skip variables that aren't allocations
         if(ins->name() != allocation_op)
-            continue;
-        alignment = std::max(allocation_segment::compute_alignment(ins), alignment);
+            return;
+        // Skip zero allocations
+        if(ins->get_shape().bytes() == 0)
+            return;
+        result.push_back({ins, pos, pos, 1 + (ins->get_shape().bytes() - 1) / alignment});
+    });
+    for(auto& interval : result)
+    {
+        auto it = last_live.find(interval.ins);
+        if(it != last_live.end())
+            interval.end = std::max(interval.end, it->second);
     }
-    return alignment;
+    return result;
 }
 
-void memory_coloring::apply(module& m) const
+// The most memory that is live at once, in units of the alignment. No placement can use less.
+static std::size_t max_live_size(const std::vector<allocation_interval>& intervals)
 {
-    const std::size_t alignment = find_max_alignment(m, allocation_op);
-    auto conflict_table         = build_conflict_table(m, allocation_op);
-    auto as                     = allocation_segment::build(m, conflict_table, alignment);
-
-    // All allocations should have a segment
-    assert(std::all_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
-        return as.get_segment(pp.first);
-    }));
+    // Allocations are added at the start and removed after the end of their interval
+    std::vector<std::pair<std::size_t, std::ptrdiff_t>> events;
+    for(const auto& interval : intervals)
+    {
+        events.emplace_back(interval.start, interval.size);
+        events.emplace_back(interval.end + 1, -std::ptrdiff_t(interval.size));
+    }
+    // Process removals first at the same position
+    std::sort(events.begin(), events.end());
+    std::ptrdiff_t live   = 0;
+    std::ptrdiff_t result = 0;
+    for(const auto& event : events)
+    {
+        live += event.second;
+        result = std::max(result, live);
+    }
+    return result;
+}
 
-    // Adjacent allocations should not have overlapping segments
-    assert(std::none_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
-        auto* x = as.get_segment(pp.first);
-        return std::any_of(pp.second.begin(), pp.second.end(), [&](auto ins) {
-            auto* y = as.get_segment(ins);
-            assert(x and y);
-            return is_overlap(*x, *y);
+// The placed allocations indexed by lifetime. The allocations are sorted by the start of their
+// interval, and a segment tree keeps the latest end of the placed allocations in each range, so
+// the placed allocations that overlap an interval are found in O(log n) each.
+struct placed_intervals
+{
+    std::vector<const allocation_interval*> sorted;
+    std::vector<std::size_t> starts;
+    // The segment tree, where 0 means there is nothing placed in the range
+    std::vector<std::size_t> max_end;
+    std::unordered_map<const allocation_interval*, std::size_t> positions;
+    std::vector<allocation_segment::segment> segments;
+
+    explicit placed_intervals(const std::vector<allocation_interval>& intervals)
+    {
+        std::transform(intervals.begin(),
+                       intervals.end(),
+                       std::back_inserter(sorted),
+                       [](const auto& x) { return &x; });
+        std::stable_sort(sorted.begin(), sorted.end(), by(std::less<>{}, [](const auto* x) {
+                             return x->start;
+                         }));
+        std::transform(sorted.begin(), sorted.end(), std::back_inserter(starts), [](auto* x) {
+            return x->start;
         });
-    }));
+        for(std::size_t i = 0; i < sorted.size(); i++)
+            positions[sorted[i]] = i;
+        max_end.resize(4 * sorted.size());
+        segments.resize(sorted.size());
+    }
 
-    // Print out segments
-    if(enabled(MIGRAPHX_DEBUG_MEMORY_COLORING{}))
+    void insert(const allocation_interval& x, allocation_segment::segment s)
     {
-        for(auto&& pp : conflict_table)
+        auto i      = positions.at(&x);
+        segments[i] = s;
+        // Store end + 1 so that placed allocations are never 0
+        std::size_t node  = 1;
+        std::size_t first = 0;
+        std::size_t last  = sorted.size();
+        for(;;)
+        {
+            max_end[node] = std::max(max_end[node], x.end + 1);
+            if(last - first == 1)
+                break;
+            auto mid = first + (last - first) / 2;
+            node *= 2;
+            if(i < mid)
+            {
+                last = mid;
+            }
+            else
+            {
+                first = mid;
+                node++;
+            }
+        }
+    }
+
+    // Visit the placed allocations whose lifetimes overlap with x, along with their segments
+    template <class F>
+    void for_each_overlap(const allocation_interval& x, F f) const
+    {
+        // Only the allocations that start before x ends can overlap
+        auto n = std::upper_bound(starts.begin(), starts.end(), x.end) - starts.begin();
+        visit(1, 0, sorted.size(), n, x.start, f);
+    }
+
+    template <class F>
+    void visit(std::size_t node,
+               std::size_t first,
+               std::size_t last,
+               std::size_t n,
+               std::size_t start,
+               F& f) const
+    {
+        if(first >= n or max_end[node] <= start)
+            return;
+        if(last - first == 1)
+        {
+            f(*sorted[first], segments[first]);
+            return;
+        }
+        auto mid = first + (last - first) / 2;
+        visit(2 * node, first, mid, n, start, f);
+        visit(2 * node + 1, mid, last, n, start, f);
+    }
+};
+
+// Place the allocations from largest to smallest, putting each one in the smallest gap left
+// between the allocations already placed whose lifetimes overlap with it.
+static allocation_segment place_best_fit(std::vector<allocation_interval> intervals)
+{
+    using segment = allocation_segment::segment;
+    std::stable_sort(intervals.begin(), intervals.end(), by(std::greater<>{}, [](const auto& x) {
+                         return x.size;
+                     }));
+    placed_intervals placed{intervals};
+    allocation_segment as{};
+    std::vector<segment> overlaps;
+    for(const auto& interval : intervals)
+    {
+        overlaps.clear();
+        placed.for_each_overlap(interval, [&](const allocation_interval&, const segment& seg) {
+            overlaps.push_back(seg);
+        });
+        std::sort(overlaps.begin(), overlaps.end());
+        std::size_t end      = 0;
+        std::size_t best     = 0;
+        std::size_t best_gap = std::numeric_limits<std::size_t>::max();
+        for(const auto& seg : overlaps)
         {
-            std::cout << "------- conflict -------" << std::endl;
-            auto s1 = as.ins2segment.at(pp.first);
-            std::cout << s1.first << ", " << s1.second << ": ";
-            m.debug_print(pp.first);
-            for(auto ins : pp.second)
+            if(seg.first > end)
             {
-                auto s2 = as.ins2segment.at(ins);
-                std::cout << s2.first << ", " << s2.second << ": ";
-                m.debug_print(ins);
+                auto gap = seg.first - end;
+                if(gap >= interval.size and gap < best_gap)
+                {
+                    best     = end;
+                    best_gap = gap;
+                }
             }
+            end = std::max(end, seg.second);
         }
+        if(best_gap == std::numeric_limits<std::size_t>::max())
+            best = end;
+        auto s = segment{best, best + interval.size};
+        placed.insert(interval, s);
+        as.add_segment(interval.ins, s);
     }
+    return as;
+}
+
+static std::size_t find_max_alignment(const module& m, const std::string& allocation_op)
+{
+    std::size_t alignment = 1;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != allocation_op)
+            continue;
+        alignment = std::max(allocation_segment::compute_alignment(ins), alignment);
+    }
+    return alignment;
+}
 
+// Compare the scratch memory used with the most memory live at once
+static void report(const module& m,
+                   const std::vector<allocation_interval>& intervals,
+                   allocation_segment& as,
+                   std::size_t alignment,
+                   const std::string& planner)
+{
+    auto scratch  = as.max() * alignment;
+    auto max_live = max_live_size(intervals) * alignment;
+    std::cout << "memory_coloring: " << m.name() << ", planner: " << planner
+              << ", allocations: " << intervals.size() << ", scratch: " << scratch
+              << " bytes, max live: " << max_live << " bytes";
+    if(max_live > 0)
+        std::cout << ", overhead: " << (100.0 * (scratch - max_live)) / max_live << "%";
+    std::cout << std::endl;
+}
+
+// Replace the allocations with loads from the scratch parameter
+static void replace_allocations(module& m,
+                                allocation_segment& as,
+                                std::size_t alignment,
+                                const std::string& allocation_op)
+{
     // Total memory
     std::size_t n = as.max() * alignment;
 
@@ -403,5 +593,100 @@ void memory_coloring::apply(module& m) const
     }
 }
 
+// Visit each allocation placed by best fit with the allocations whose lifetimes overlap with it
+template <class F>
+static void for_each_conflict(const std::vector<allocation_interval>& intervals,
+                              const allocation_segment& as,
+                              F f)
+{
+    placed_intervals placed{intervals};
+    for(const auto& interval : intervals)
+        placed.insert(interval, *as.get_segment(interval.ins));
+    std::vector<instruction_ref> conflicts;
+    for(const auto& interval : intervals)
+    {
+        conflicts.clear();
+        placed.for_each_overlap(interval, [&](const allocation_interval& y, const auto&) {
+            if(y.ins != interval.ins)
+                conflicts.push_back(y.ins);
+        });
+        f(interval.ins, conflicts);
+    }
+}
+
+static void debug_print_segments(const module& m,
+                                 const allocation_segment& as,
+                                 instruction_ref ins,
+                                 const std::vector<instruction_ref>& conflicts)
+{
+    std::cout << "------- conflict -------" << std::endl;
+    auto s1 = as.ins2segment.at(ins);
+    std::cout << s1.first << ", " << s1.second << ": ";
+    m.debug_print(ins);
+    for(auto conflict : conflicts)
+    {
+        auto s2 = as.ins2segment.at(conflict);
+        std::cout << s2.first << ", " << s2.second << ": ";
+        m.debug_print(conflict);
+    }
+}
+
+void memory_coloring::apply(module& m) const
+{
+    const std::size_t alignment = find_max_alignment(m, allocation_op);
+    if(best_fit)
+    {
+        auto intervals = build_intervals(m, allocation_op, alignment);
+        auto as        = place_best_fit(intervals);
+#ifndef NDEBUG
+        // Allocations that are live together should not have overlapping segments
+        for_each_conflict(intervals, as, [&](auto ins, const auto& conflicts) {
+            assert(std::none_of(conflicts.begin(), conflicts.end(), [&](auto conflict) {
+                return is_overlap(*as.get_segment(ins), *as.get_segment(conflict));
+            }));
+        });
+#endif
+        if(enabled(MIGRAPHX_TRACE_MEMORY_COLORING{}))
+            report(m, intervals, as, alignment, "best_fit");
+        if(enabled(MIGRAPHX_DEBUG_MEMORY_COLORING{}))
+        {
+            for_each_conflict(intervals, as, [&](auto ins, const auto& conflicts) {
+                debug_print_segments(m, as, ins, conflicts);
+            });
+        }
+        replace_allocations(m, as, alignment, allocation_op);
+        return;
+    }
+    auto conflict_table = build_conflict_table(m, allocation_op);
+    auto as             = allocation_segment::build(m, conflict_table, alignment);
+
+    // All allocations should have a segment
+    assert(std::all_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
+        return as.get_segment(pp.first);
+    }));
+
+    // Adjacent allocations should not have overlapping segments
+    assert(std::none_of(conflict_table.begin(), conflict_table.end(), [&](auto&& pp) {
+        auto* x = as.get_segment(pp.first);
+        return std::any_of(pp.second.begin(), pp.second.end(), [&](auto ins) {
+            auto* y = as.get_segment(ins);
+            assert(x and y);
+            return is_overlap(*x, *y);
+        });
+    }));
+
+    if(enabled(MIGRAPHX_TRACE_MEMORY_COLORING{}))
+        report(m, build_intervals(m, allocation_op, alignment), as, alignment, "coloring");
+
+    // Print out segments
+    if(enabled(MIGRAPHX_DEBUG_MEMORY_COLORING{}))
+    {
+        for(auto&& pp : conflict_table)
+            debug_print_segments(m, as, pp.first, {pp.second.begin(), pp.second.end()});
+    }
+
+    replace_allocations(m, as, alignment, allocation_op);
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
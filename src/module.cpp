@@ -55,6 +55,8 @@ struct module_impl
     std::string name;
     uint32_t nparams = 0;
     bool bypass      = false;
+    // Incremented by every change to the instructions
+    std::size_t changes = 0;
 
     bool contains(instruction_ref ins) const
     {
@@ -69,6 +71,7 @@ struct module_impl
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        changes++;
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
@@ -102,12 +105,14 @@ struct module_impl
     instruction_ref erase(instruction_ref pos)
     {
         instruction_set.erase(std::addressof(*pos));
+        changes++;
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        changes++;
         return instructions.erase(start, last);
     }
 };
@@ -137,6 +142,8 @@ std::string module::name() const { return impl->name; }
 bool module::bypass() const { return impl->bypass; }
 void module::set_bypass(bool b) { impl->bypass = b; }
 
+std::size_t module::get_changes() const { return impl->changes; }
+
 void module::assign(const module& m)
 {
     // copy the impl
@@ -301,6 +308,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
     shape r = compute_shape(op, args);
     instruction::replace(ins, op, r, std::move(args));
+    impl->changes++;
     assert(ins->valid(begin()));
     return ins;
 }
@@ -314,6 +322,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
     instruction::replace(ins, op, out_shape, std::move(args), std::move(module_args));
+    impl->changes++;
     assert(ins->valid(begin()));
     return ins;
 }
@@ -336,6 +345,7 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     {
         return rep;
     }
+    impl->changes++;
     // Make a copy of outputs which can be changed when calling replace_argument
     auto outputs = ins->outputs();
     for(auto out : outputs)
@@ -382,6 +392,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
+    impl->changes++;
     return src;
 }
 
@@ -491,6 +502,7 @@ instruction_ref module::replace_return(std::vector<instruction_ref> args)
 
     shape r = compute_shape(last->get_operator(), args);
     instruction::replace(last, last->get_operator(), r, std::move(args));
+    impl->changes++;
     assert(last->valid(begin()));
 
     return last;
@@ -655,6 +667,7 @@ instruction_ref module::find_dangling_reference() const
 void module::finalize(std::vector<context>& contexts)
 {
     assert(not contexts.empty());
+    impl->changes++;
     const bool trace = enabled(MIGRAPHX_TRACE_FINALIZE{});
     for(auto ins : iterator_for(*this))
     {
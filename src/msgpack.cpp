@@ -23,8 +23,27 @@
  */
 #include <migraphx/msgpack.hpp>
 #include <migraphx/serialize.hpp>
+#include <migraphx/stringutils.hpp>
 #include <msgpack.hpp>
 
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Keys inserted in front of aligned binaries, these are dropped when reading
+static const std::string& msgpack_padding_prefix()
+{
+    static const std::string prefix = "@padding:";
+    return prefix;
+}
+
+static bool is_msgpack_padding(const std::string& key)
+{
+    return starts_with(key, msgpack_padding_prefix());
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
 namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
 {
@@ -80,7 +99,10 @@ MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
                 std::for_each(o.via.map.ptr,
                               o.via.map.ptr + o.via.map.size,
                               [&](const msgpack::object_kv& p) {
-                                  r[p.key.as<std::string>()] = p.val.as<migraphx::value>();
+                                  auto key = p.key.as<std::string>();
+                                  if(migraphx::is_msgpack_padding(key))
+                                      return;
+                                  r[key] = p.val.as<migraphx::value>();
                               });
                 v = r;
                 break;
@@ -175,30 +197,233 @@ struct vector_stream
 struct writer_stream
 {
     std::function<void(const char*, std::size_t)> writer;
+    std::size_t offset = 0;
     writer_stream& write(const char* b, std::size_t n)
     {
         writer(b, n);
+        offset += n;
         return *this;
     }
 };
 
-void to_msgpack(const value& v, std::function<void(const char*, std::size_t)> writer)
+// Number of bytes msgpack uses to encode the argument
+template <class F>
+static std::size_t msgpack_size(F f)
+{
+    vector_stream vs;
+    msgpack::packer<vector_stream> p{vs};
+    f(p);
+    return vs.buffer.size();
+}
+
+// Packs a value like the msgpack adaptor does, but every binary in an object that is at least
+// `alignment` bytes is preceded by a padding entry so that its payload starts at a multiple of
+// `alignment` from the beginning of the stream. Smaller binaries of at least
+// msgpack_min_alignment bytes are aligned to msgpack_min_alignment. The data of a literal that is
+// {"@binary": i} is written as the binary refs[i].
+struct aligned_msgpack_writer
+{
+    writer_stream& stream;
+    std::size_t alignment;
+    const std::vector<msgpack_binary_ref>& refs;
+    msgpack::packer<writer_stream> packer{stream};
+    // The refs are written in order, so a placeholder is only used when it refers to the next one
+    std::size_t next_ref = 0;
+
+    const msgpack_binary_ref* get_ref(const value& x, bool literal_data) const
+    {
+        if(not literal_data or next_ref >= refs.size())
+            return nullptr;
+        if(not x.is_object() or x.size() != 1 or not x.contains("@binary"))
+            return nullptr;
+        const auto& i = x.at("@binary");
+        if(not(i.is_uint64() or i.is_int64()) or i.to<std::size_t>() != next_ref)
+            return nullptr;
+        return &refs[next_ref];
+    }
+
+    std::size_t binary_size(const value& x, bool literal_data) const
+    {
+        if(x.is_binary())
+            return x.get_binary().size();
+        const auto* ref = get_ref(x, literal_data);
+        if(ref != nullptr)
+            return ref->size;
+        return 0;
+    }
+
+    std::size_t binary_alignment(const value& x, bool literal_data) const
+    {
+        if(alignment == 0)
+            return 0;
+        auto n = binary_size(x, literal_data);
+        if(n >= alignment)
+            return alignment;
+        if(n >= msgpack_min_alignment)
+            return msgpack_min_alignment;
+        return 0;
+    }
+
+    std::size_t padding_size(const std::string& key, std::size_t nbytes, std::size_t align) const
+    {
+        auto pad_key = msgpack_padding_prefix() + key;
+        auto start   = stream.offset + msgpack_size([&](auto& p) { p.pack(pad_key); }) +
+                     msgpack_size([&](auto& p) { p.pack(key); }) +
+                     msgpack_size([&](auto& p) { p.pack_bin(nbytes); });
+        // The size of the padding changes the size of its own header
+        for(std::size_t n = 0;; n++)
+        {
+            if((start + msgpack_size([&](auto& p) { p.pack_bin(n); }) + n) % align == 0)
+                return n;
+        }
+    }
+
+    void write_padding(const std::string& key, std::size_t nbytes, std::size_t align)
+    {
+        auto n = padding_size(key, nbytes, align);
+        std::vector<char> zeros(n);
+        packer.pack(msgpack_padding_prefix() + key);
+        packer.pack_bin(n);
+        packer.pack_bin_body(zeros.data(), n);
+    }
+
+    void write(const value& v, bool literal_data = false, bool literal = false)
+    {
+        const auto* ref = get_ref(v, literal_data);
+        if(ref != nullptr)
+        {
+            packer.pack_bin(ref->size);
+            packer.pack_bin_body(ref->data, ref->size);
+            next_ref++;
+        }
+        else if(v.is_array() or v.is_object())
+        {
+            write_elements(v, literal);
+        }
+        else
+        {
+            packer.pack(v);
+        }
+    }
+
+    void write_elements(const value& v, bool literal)
+    {
+        if(v.empty())
+        {
+            packer.pack_array(0);
+            return;
+        }
+        if(v.is_array())
+        {
+            packer.pack_array(v.size());
+            for(auto&& x : v)
+                write(x);
+            return;
+        }
+        auto is_literal_data = [&](const value& x) { return literal and x.get_key() == "data"; };
+        std::size_t n = std::count_if(v.begin(), v.end(), [&](const value& x) {
+            return binary_alignment(x, is_literal_data(x)) > 0;
+        });
+        packer.pack_map(v.size() + n);
+        // The keys are ignored when packing the elements themselves
+        for(auto&& x : v)
+        {
+            auto literal_data = is_literal_data(x);
+            auto align        = binary_alignment(x, literal_data);
+            if(align > 0)
+                write_padding(x.get_key(), binary_size(x, literal_data), align);
+            packer.pack(x.get_key());
+            write(x, literal_data, x.get_key() == "literal");
+        }
+    }
+};
+
+void to_msgpack(const value& v,
+                std::function<void(const char*, std::size_t)> writer,
+                std::size_t alignment)
+{
+    to_msgpack(v, std::move(writer), alignment, {});
+}
+
+void to_msgpack(const value& v,
+                std::function<void(const char*, std::size_t)> writer,
+                std::size_t alignment,
+                const std::vector<msgpack_binary_ref>& refs)
 {
     writer_stream ws{std::move(writer)};
-    msgpack::pack(ws, v);
+    if(alignment == 0 and refs.empty())
+    {
+        msgpack::pack(ws, v);
+        return;
+    }
+    aligned_msgpack_writer{ws, alignment, refs}.write(v);
 }
 
-std::vector<char> to_msgpack(const value& v)
+std::vector<char> to_msgpack(const value& v, std::size_t alignment)
 {
-    vector_stream vs;
-    msgpack::pack(vs, v);
-    return vs.buffer;
+    if(alignment == 0)
+    {
+        vector_stream vs;
+        msgpack::pack(vs, v);
+        return vs.buffer;
+    }
+    std::vector<char> buffer;
+    to_msgpack(
+        v, [&](const char* b, std::size_t n) { buffer.insert(buffer.end(), b, b + n); }, alignment);
+    return buffer;
 }
+
 value from_msgpack(const char* buffer, std::size_t size)
 {
     msgpack::object_handle oh = msgpack::unpack(buffer, size);
     return oh.get().as<value>();
 }
+
+// Converts the object, but binaries that were referenced from the buffer by the unpacker are
+// replaced by their location in the buffer
+static value from_msgpack_object(const msgpack::object& o, const char* buffer, std::size_t min_size)
+{
+    if(o.type == msgpack::type::BIN and o.via.bin.size >= min_size)
+    {
+        auto offset = static_cast<std::size_t>(o.via.bin.ptr - buffer);
+        return {{"@offset", offset}, {"@size", std::size_t{o.via.bin.size}}};
+    }
+    if(o.type == msgpack::type::ARRAY)
+    {
+        value r = value::array{};
+        std::for_each(o.via.array.ptr,
+                      o.via.array.ptr + o.via.array.size,
+                      [&](const msgpack::object& so) {
+                          r.push_back(from_msgpack_object(so, buffer, min_size));
+                      });
+        return r;
+    }
+    if(o.type == msgpack::type::MAP)
+    {
+        value r = value::object{};
+        std::for_each(
+            o.via.map.ptr, o.via.map.ptr + o.via.map.size, [&](const msgpack::object_kv& p) {
+                auto key = p.key.as<std::string>();
+                if(is_msgpack_padding(key))
+                    return;
+                r[key] = from_msgpack_object(p.val, buffer, min_size);
+            });
+        return r;
+    }
+    return o.as<value>();
+}
+
+static bool reference_binary(msgpack::type::object_type type, std::size_t n, void* min_size)
+{
+    return type == msgpack::type::BIN and n >= *static_cast<std::size_t*>(min_size);
+}
+
+value from_msgpack_view(const char* buffer, std::size_t size, std::size_t min_size)
+{
+    msgpack::object_handle oh = msgpack::unpack(buffer, size, &reference_binary, &min_size);
+    return from_msgpack_object(oh.get(), buffer, min_size);
+}
+
 value from_msgpack(const std::vector<char>& buffer)
 {
     return from_msgpack(buffer.data(), buffer.size());
@@ -31,6 +31,8 @@
 #include <onnx.pb.h>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -104,6 +106,15 @@ struct onnx_parser
 
     std::unordered_map<std::string, op_func> ops;
 
+    // External data files are mapped once, and the literals view the mapping
+    struct mapped_file
+    {
+        std::shared_ptr<char> data = nullptr;
+        std::size_t size           = 0;
+    };
+    mutable std::unordered_map<std::string, mapped_file> external_files;
+    mutable std::mutex external_files_mutex;
+
     onnx_parser();
     operation load(const std::string& name, const node_info& info) const;
 
@@ -117,6 +128,7 @@ struct onnx_parser
     parse_graph(module* mod, const onnx::GraphProto& graph, bool inlining = false);
     literal parse_value(const onnx::AttributeProto& attr) const;
     literal parse_tensor(const onnx::TensorProto& t) const;
+    mapped_file map_external_file(const std::string& filename) const;
     shape parse_type(const onnx::TypeProto& t) const;
     shape parse_type(const onnx::TypeProto& t, const std::vector<std::size_t>& input_dims) const;
 };
@@ -34,7 +34,9 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/filesystem.hpp>
 #include <migraphx/op/unknown.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/env.hpp>
+#include <cstddef>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -322,12 +324,18 @@ std::unordered_map<std::string, instruction_ref>
 parse_intializer(const onnx_parser& parser, module* mod, const onnx::GraphProto& graph)
 {
     std::unordered_map<std::string, instruction_ref> mod_insts;
-    for(auto&& f : graph.initializer())
+    const auto& initializers = graph.initializer();
+    // Decode the tensors in parallel, only adding them to the module is sequential
+    std::vector<literal> literals(initializers.size());
+    par_for(initializers.size(),
+            [&](auto i) { literals[i] = parser.parse_tensor(initializers.Get(i)); });
+    for(int i = 0; i < initializers.size(); i++)
     {
+        const auto& f = initializers.Get(i);
         if(enabled(MIGRAPHX_TRACE_ONNX_PARSER{}))
             std::cout << "initializer: " << f.name() << std::endl;
         // backup instructions in parent mod
-        mod_insts[f.name()] = mod->add_literal(parser.parse_tensor(f));
+        mod_insts[f.name()] = mod->add_literal(std::move(literals[i]));
         if(enabled(MIGRAPHX_TRACE_ONNX_PARSER{}))
             mod->debug_print(mod_insts[f.name()]);
     }
@@ -510,9 +518,21 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
         {
             nbytes = std::stoul(t.external_data().at(2).value());
         }
-        auto raw_buffer = read_buffer(path + "/" + data_file, offset, nbytes);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        return create_literal(type, dims, s.data());
+        if(nbytes < tensor_shape.bytes())
+            MIGRAPHX_THROW("PARSE_TENSOR: external data for " + t.name() + " is too small");
+        if(tensor_shape.elements() == 0)
+            return literal{type};
+        auto file = map_external_file(path + "/" + data_file);
+        if(offset + tensor_shape.bytes() > file.size)
+            MIGRAPHX_THROW("PARSE_TENSOR: external data for " + t.name() + " is out of range of " +
+                           data_file);
+        // View the mapping directly when the data is suitably aligned for the literal
+        if(offset % alignof(std::max_align_t) == 0)
+        {
+            shape s = dims.empty() ? shape{type} : tensor_shape;
+            return literal{s, std::shared_ptr<char>(file.data, file.data.get() + offset)};
+        }
+        return create_literal(type, dims, file.data.get() + offset);
     }
     if(t.has_raw_data())
     {
@@ -552,6 +572,19 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     }
     MIGRAPHX_THROW("PARSE_TENSOR: Invalid tensor type");
 }
+
+onnx_parser::mapped_file onnx_parser::map_external_file(const std::string& filename) const
+{
+    std::lock_guard<std::mutex> lock(external_files_mutex);
+    auto it = external_files.find(filename);
+    if(it != external_files.end())
+        return it->second;
+    mapped_file file;
+    file.data = map_buffer(filename, file.size);
+    external_files.emplace(filename, file);
+    return file;
+}
+
 shape onnx_parser::parse_type(const onnx::TypeProto& t) const
 {
     shape::type_t shape_type = get_type(t.tensor_type().elem_type());
@@ -30,7 +30,9 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/time.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/thread_pool.hpp>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <algorithm>
 #include <utility>
@@ -40,6 +42,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_PASSES);
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIME_PASSES);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_PARALLEL_PASSES);
 
 void validate_pass(module& mod, const pass& p, tracer trace)
 {
@@ -109,26 +112,70 @@ struct module_pm : module_pass_manager
         return prog->get_main_module();
     }
 
-    virtual void run_pass(const pass& p) override
+    // Apply the pass and return the time it took in milliseconds
+    double apply_pass(const pass& p)
     {
         trace("Pass: ", p.name());
         assert(mod);
         assert(mod->validate() == mod->end());
-        if(enabled(MIGRAPHX_TIME_PASSES{}))
-        {
-            using milliseconds = std::chrono::duration<double, std::milli>;
-            auto ms            = time<milliseconds>([&] { p.apply(*this); });
-            std::cout << p.name() << ": " << ms << "ms\n";
-        }
-        else
-        {
-            p.apply(*this);
-        }
+        using milliseconds = std::chrono::duration<double, std::milli>;
+        auto ms            = time<milliseconds>([&] { p.apply(*this); });
         trace(*mod);
         validate_pass(*mod, p, *t);
+        return ms;
+    }
+
+    virtual void run_pass(const pass& p) override
+    {
+        auto ms = apply_pass(p);
+        if(enabled(MIGRAPHX_TIME_PASSES{}))
+            std::cout << p.name() << ": " << ms << "ms\n";
     }
 };
 
+// A module can be given to a module local pass at the same time as other modules when it has no
+// submodules and none of its instructions use instructions from another module
+static bool is_independent_module(const module& m)
+{
+    return std::all_of(m.begin(), m.end(), [&](const instruction& ins) {
+        return ins.module_inputs().empty() and
+               std::all_of(ins.inputs().begin(), ins.inputs().end(), [&](instruction_ref input) {
+                   return m.has_instruction(input);
+               });
+    });
+}
+
+// Apply the pass to each module using the thread pool
+static void run_pass_parallel(const std::vector<std::pair<module_ref, module_ref>>& mods,
+                              module_ref root_mod,
+                              program& prog,
+                              tracer& trace,
+                              const pass& p)
+{
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    std::vector<double> times(mods.size());
+    auto& pool    = get_thread_pool();
+    auto nthreads = std::min(mods.size(), pool.size());
+    auto total    = time<milliseconds>([&] {
+        pool.parallel_for(mods.size(), nthreads, 1, [&](auto start, auto last, auto) {
+            for(auto i = start; i < last; i++)
+            {
+                module_pm mpm{mods[i].first, root_mod, &trace};
+                mpm.prog          = &prog;
+                mpm.common_parent = mods[i].second;
+                times[i]          = mpm.apply_pass(p);
+            }
+        });
+    });
+    if(enabled(MIGRAPHX_TIME_PASSES{}))
+    {
+        auto sequential = std::accumulate(times.begin(), times.end(), 0.0);
+        std::cout << p.name() << ": " << total << "ms for " << mods.size()
+                  << " modules in parallel, " << sequential << "ms sequentially, saved "
+                  << (sequential - total) << "ms\n";
+    }
+}
+
 module& get_module(module_pass_manager& mpm) { return mpm.get_module(); }
 
 void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& passes, tracer trace)
@@ -142,6 +189,11 @@ void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& pas
         std::vector<module_ref> sub_mods = root_mod->get_sub_modules();
         sub_mods.insert(sub_mods.begin(), root_mod);
         visited.clear();
+        // Independent modules are collected to run in parallel, the traces would be interleaved
+        // so they are only collected when tracing is off
+        bool parallel = enabled(MIGRAPHX_PARALLEL_PASSES{}) and p.is_module_local() and
+                        not trace.enabled();
+        std::vector<std::pair<module_ref, module_ref>> independent;
         for(const auto& mod : reverse(sub_mods))
         {
             if(mod->bypass())
@@ -160,8 +212,20 @@ void run_passes(program& prog, module_ref root_mod, const std::vector<pass>& pas
                 // Just set common parent to main module when there is muliple parents for now
                 // TODO: Compute the common parent
                 mpm.common_parent = prog.get_main_module();
+            if(parallel and mod != root_mod and is_independent_module(*mod))
+            {
+                independent.emplace_back(mod, mpm.common_parent);
+                continue;
+            }
+            // The submodules are visited first, so the independent modules collected so far must
+            // run before this module
+            if(not independent.empty())
+                run_pass_parallel(independent, root_mod, prog, trace, p);
+            independent.clear();
             mpm.run_pass(p);
         }
+        if(not independent.empty())
+            run_pass_parallel(independent, root_mod, prog, trace, p);
         run_pass(prog, p, trace);
     }
 }
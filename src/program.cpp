@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/version.h>
+#include <migraphx/compile_cache.hpp>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/stringutils.hpp>
@@ -50,6 +51,7 @@
 #include <utility>
 #include <unordered_set>
 #include <map>
+#include <mutex>
 #include <cassert>
 
 namespace migraphx {
@@ -68,12 +70,163 @@ struct mark_instruction_target
     }
 };
 
+// A flattened form of a module used to evaluate it without hashing instructions
+struct execution_plan
+{
+    enum class step_kind
+    {
+        value,
+        param,
+        compute,
+        ret
+    };
+
+    struct step
+    {
+        step_kind kind = step_kind::value;
+        instruction_ref ins;
+        // The normalized operator, only used for compute steps
+        operation op;
+        // Index of the step of each input
+        std::vector<std::size_t> inputs;
+        // Precomputed result for literals and outlines
+        argument result;
+        std::string param_name;
+        // Instructions of this module used by the submodules, and the index of their step
+        std::vector<std::pair<instruction_ref, std::size_t>> captures;
+    };
+
+    const module* mod = nullptr;
+    // The modules the plan was built from and their number of changes at that time
+    std::vector<std::pair<const module*, std::size_t>> modules;
+    std::vector<step> steps;
+    // Whether the module can be evaluated with this plan
+    bool usable = true;
+
+    bool is_valid_for(const module* m) const
+    {
+        return m == mod and std::all_of(modules.begin(), modules.end(), [](const auto& p) {
+                   return p.first->get_changes() == p.second;
+               });
+    }
+};
+
+static std::shared_ptr<execution_plan> make_execution_plan(const module* mod)
+{
+    auto plan = std::make_shared<execution_plan>();
+    plan->mod = mod;
+    plan->modules.emplace_back(mod, mod->get_changes());
+    plan->steps.reserve(mod->size());
+    std::unordered_map<instruction_ref, std::size_t> ins2step;
+    ins2step.reserve(mod->size());
+    for(auto ins : iterator_for(*mod))
+    {
+        execution_plan::step s;
+        s.ins            = ins;
+        const auto& name = ins->name();
+        if(name == "@literal")
+        {
+            // The plan lives as long as the program, so it shares the literal's buffer instead of
+            // keeping a second copy of it
+            s.result = ins->get_literal().get_argument_view();
+        }
+        else if(name == "@outline")
+        {
+            s.result = argument{ins->get_shape(), nullptr};
+        }
+        else if(name == "@param")
+        {
+            s.kind       = execution_plan::step_kind::param;
+            s.param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
+        }
+        else
+        {
+            s.kind = name == "@return" ? execution_plan::step_kind::ret
+                                       : execution_plan::step_kind::compute;
+            // Inputs from a parent module cant be resolved in this plan
+            if(std::any_of(ins->inputs().begin(), ins->inputs().end(), [&](auto input) {
+                   return not contains(ins2step, input);
+               }))
+            {
+                plan->steps.clear();
+                plan->usable = false;
+                return plan;
+            }
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(s.inputs),
+                           [&](auto input) { return ins2step.at(input); });
+            if(s.kind == execution_plan::step_kind::compute)
+                s.op = ins->normalized_operator();
+            // Submodules can reference instructions from this module
+            for(auto* smod : ins->module_inputs())
+            {
+                auto smods = smod->get_sub_modules();
+                smods.insert(smods.begin(), smod);
+                for(auto* m : smods)
+                {
+                    plan->modules.emplace_back(m, m->get_changes());
+                    for(const auto& sins : *m)
+                    {
+                        for(auto input : sins.inputs())
+                        {
+                            auto it = ins2step.find(input);
+                            if(it == ins2step.end() or
+                               contains(s.captures, std::make_pair(input, it->second)))
+                                continue;
+                            s.captures.emplace_back(input, it->second);
+                        }
+                    }
+                }
+            }
+        }
+        ins2step.emplace(ins, plan->steps.size());
+        plan->steps.push_back(std::move(s));
+    }
+    return plan;
+}
+
+// Holds the plan of the main module, it is rebuilt when the module changes. The lock lets
+// concurrent calls to eval share it.
+struct execution_plan_cache
+{
+    execution_plan_cache() = default;
+    // Copies start without a plan since it refers to the instructions of the other program
+    execution_plan_cache(const execution_plan_cache&) {}
+    execution_plan_cache& operator=(const execution_plan_cache&)
+    {
+        reset();
+        return *this;
+    }
+
+    std::shared_ptr<execution_plan> get(const module* mod)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(plan == nullptr or not plan->is_valid_for(mod))
+            plan = make_execution_plan(mod);
+        if(not plan->usable)
+            return nullptr;
+        return plan;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        plan = nullptr;
+    }
+
+    private:
+    std::mutex m;
+    std::shared_ptr<execution_plan> plan;
+};
+
 struct program_impl
 {
     // A map is used to keep references to modules of the program
     std::unordered_map<std::string, module> modules;
     std::vector<context> contexts;
     std::vector<target> targets;
+    execution_plan_cache plan;
 };
 
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
@@ -127,6 +280,21 @@ void program::assign(const program& p)
         for(auto ins : iterator_for(mp.second))
             instruction::replace_refs(ins, ins_map, mod_map);
     }
+
+    if(is_compiled())
+    {
+        // Operators that keep state about their submodules, like the dispatch table of
+        // select_module, still refer to the modules of p, so finalize them with the copies
+        for(auto&& mp : impl->modules)
+        {
+            for(auto ins : iterator_for(mp.second))
+            {
+                if(not ins->module_inputs().empty())
+                    ins->finalize(impl->contexts[ins->get_target_id()]);
+            }
+        }
+        impl->plan.get(this->get_main_module());
+    }
 }
 
 shape program::get_parameter_shape(std::string name) const
@@ -309,6 +477,19 @@ void program::compile(const target& t, compile_options options)
     assert(not this->is_compiled());
     this->impl->targets  = {t};
     this->impl->contexts = {t.get_context()};
+    auto cache           = compile_cache::from_env();
+    value cache_description;
+    if(cache.has_value())
+    {
+        cache_description =
+            compile_cache::describe(*this, t, this->impl->contexts.front(), options);
+        auto cached = cache->load(cache_description);
+        if(cached.has_value())
+        {
+            *this = std::move(*cached);
+            return;
+        }
+    }
 
     if(enabled(MIGRAPHX_TRACE_COMPILE{}))
         options.trace = tracer{std::cout};
@@ -336,12 +517,16 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->contexts);
     }
+    this->impl->plan.get(this->get_main_module());
+    if(cache.has_value())
+        cache->store(cache_description, *this);
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->contexts);
+    this->impl->plan.get(mm);
 }
 
 template <class T>
@@ -429,7 +614,7 @@ void preview_argument(std::ostream& os, const argument& a)
 template <class F>
 std::vector<argument> generic_eval(const module* mod,
                                    std::vector<context>& ctx,
-                                   std::unordered_map<std::string, argument> params,
+                                   const std::unordered_map<std::string, argument>& params,
                                    std::unordered_map<instruction_ref, argument> results,
                                    F trace)
 {
@@ -450,9 +635,10 @@ std::vector<argument> generic_eval(const module* mod,
             results.emplace(
                 ins, trace(ins, [&] {
                     auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
+                    auto it         = params.find(param_name);
+                    if(it == params.end())
                         MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
+                    const auto& param = it->second;
                     // TODO: may want to check correct number of dimensions and/or was within bounds
                     if(not ins->get_shape().any_of_dynamic() and
                        param.get_shape() != ins->get_shape())
@@ -525,6 +711,82 @@ std::vector<argument> generic_eval(const program& p,
     return generic_eval(mm, ctx, params, {}, trace);
 }
 
+static argument get_param(const parameter_map& params,
+                          const std::string& param_name,
+                          const shape& param_shape)
+{
+    auto it = params.find(param_name);
+    if(it == params.end())
+        MIGRAPHX_THROW("Parameter not found: " + param_name);
+    if(not param_shape.any_of_dynamic() and it->second.get_shape() != param_shape)
+    {
+        MIGRAPHX_THROW("Incorrect shape {" + to_string(it->second.get_shape()) +
+                       "} for parameter: " + param_name + " should be: " + to_string(param_shape));
+    }
+    return it->second;
+}
+
+// Evaluate the main module using the plan built at finalize, this avoids
+// hashing instructions and copying operators for every instruction
+static std::vector<argument>
+plan_eval(const execution_plan& plan, std::vector<context>& ctx, const parameter_map& params)
+{
+    std::vector<argument> results(plan.steps.size());
+    std::vector<argument> values;
+    values.reserve(16);
+    for(std::size_t i = 0; i < plan.steps.size(); i++)
+    {
+        const auto& s = plan.steps[i];
+        switch(s.kind)
+        {
+        case execution_plan::step_kind::value: results[i] = s.result; break;
+        case execution_plan::step_kind::param:
+            results[i] = get_param(params, s.param_name, s.ins->get_shape());
+            break;
+        case execution_plan::step_kind::ret: {
+            std::vector<argument> prog_outputs(s.inputs.size());
+            std::transform(s.inputs.begin(),
+                           s.inputs.end(),
+                           prog_outputs.begin(),
+                           [&](std::size_t j) { return results[j]; });
+            return prog_outputs;
+        }
+        case execution_plan::step_kind::compute: {
+            values.resize(s.inputs.size());
+            std::transform(s.inputs.begin(), s.inputs.end(), values.begin(), [&](std::size_t j) {
+                return results[j];
+            });
+            const auto& mod_args = s.ins->module_inputs();
+            auto module_eval     = [&](module_ref smod,
+                                   const std::unordered_map<std::string, argument>& inputs) {
+                std::unordered_map<instruction_ref, argument> outer;
+                for(const auto& [input, j] : s.captures)
+                    outer.emplace(input, results[j]);
+                return generic_eval(smod, ctx, inputs, outer, [](auto&&, auto f) { return f(); });
+            };
+            if(s.op.is_context_free())
+            {
+                results[i] = s.op.compute(s.ins->get_shape(), values, mod_args, module_eval);
+            }
+            else
+            {
+                auto target_id = s.ins->get_target_id();
+                if(target_id >= ctx.size())
+                    MIGRAPHX_THROW("No context available for " + s.op.name());
+                results[i] =
+                    s.op.compute(ctx[target_id], s.ins->get_shape(), values, mod_args, module_eval);
+            }
+            break;
+        }
+        }
+        assert(s.ins->get_shape().any_of_dynamic() or
+               results[i].get_shape() == s.ins->get_shape());
+    }
+    if(results.empty())
+        return {};
+    return {results.back()};
+}
+
 std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
 {
     auto& contexts = this->impl->contexts;
@@ -592,6 +854,15 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
             return result;
         });
     }
+    else if(this->is_compiled())
+    {
+        auto plan = this->impl->plan.get(this->get_main_module());
+        if(plan != nullptr)
+            ret = plan_eval(*plan, contexts, params);
+        else
+            ret = generic_eval(
+                *this, contexts, std::move(params), [&](auto&&, auto f) { return f(); });
+    }
     else
     {
         ret = generic_eval(*this, contexts, std::move(params), [&](auto&&, auto f) { return f(); });
@@ -623,10 +894,19 @@ std::string get_migraphx_version()
 /*
 program file version is for the data structure or format of the MXR file. Version should be bumped
 if any changes occur to the format of the MXR file.
+
+Version 7 aligns the literal data in msgpack files so they can be memory mapped, and writes
+literals that share a buffer once. Version 6 files have neither and can still be read.
 */
-const int program_file_version = 6;
+const int program_file_version        = 7;
+const int oldest_program_file_version = 6;
 
 value program::to_value() const
+{
+    return this->to_value([](const literal& l) { return migraphx::to_value(l); });
+}
+
+value program::to_value(const std::function<value(const literal&)>& literal_to_value) const
 {
     value result;
     result["version"]          = program_file_version;
@@ -648,7 +928,7 @@ value program::to_value() const
                 node["shape"]      = migraphx::to_value(ins->get_shape());
                 node["normalized"] = ins->is_normalized();
                 if(ins->name() == "@literal")
-                    node["literal"] = migraphx::to_value(ins->get_literal());
+                    node["literal"] = literal_to_value(ins->get_literal());
                 node["operator"] = ins->get_operator().to_value();
                 std::vector<std::string> inputs;
                 std::transform(ins->inputs().begin(),
@@ -686,7 +966,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const std::function<literal(const value&)>& make_literal)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -704,8 +985,7 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output =
-                mod->insert_literal(mod->end(), migraphx::from_value<literal>(node.at("literal")));
+            output = mod->insert_literal(mod->end(), make_literal(node.at("literal")));
         }
         else
         {
@@ -730,7 +1010,7 @@ static void mod_from_val(module_ref mod,
 
                 for(const auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, make_literal);
                 }
             }
 
@@ -753,9 +1033,14 @@ static void mod_from_val(module_ref mod,
 }
 
 void program::from_value(const value& v)
+{
+    this->from_value(v, [](const value& lv) { return migraphx::from_value<literal>(lv); });
+}
+
+void program::from_value(const value& v, const std::function<literal(const value&)>& make_literal)
 {
     auto version = v.at("version").to<int>();
-    if(version != program_file_version)
+    if(version < oldest_program_file_version or version > program_file_version)
     {
         MIGRAPHX_THROW(
             "Error: Program version mismatch. MXR file was created using program file version: " +
@@ -796,7 +1081,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, make_literal);
 
     // Finalize a compiled model
     if(not this->impl->contexts.empty())
@@ -560,12 +560,30 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
           &migraphx::quantize_fp16,
           py::arg("prog"),
           py::arg("ins_names") = std::vector<std::string>{"all"});
-    m.def("quantize_int8",
-          &migraphx::quantize_int8,
-          py::arg("prog"),
-          py::arg("t"),
-          py::arg("calibration") = std::vector<migraphx::parameter_map>{},
-          py::arg("ins_names")   = std::vector<std::string>{"dot", "convolution"});
+    m.def(
+        "quantize_int8",
+        [](migraphx::program& p,
+           const migraphx::target& t,
+           const std::vector<migraphx::parameter_map>& calibration,
+           const std::vector<std::string>& ins_names,
+           const std::string& method,
+           bool per_channel_weights) {
+            migraphx::calibration_options options;
+            options.per_channel_weights = per_channel_weights;
+            if(method == "percentile")
+                options.method = migraphx::calibration_method::percentile;
+            else if(method == "entropy")
+                options.method = migraphx::calibration_method::entropy;
+            else if(method != "max_abs")
+                MIGRAPHX_THROW("Unknown calibration method: " + method);
+            migraphx::quantize_int8(p, t, calibration, ins_names, options);
+        },
+        py::arg("prog"),
+        py::arg("t"),
+        py::arg("calibration")         = std::vector<migraphx::parameter_map>{},
+        py::arg("ins_names")           = std::vector<std::string>{"dot", "convolution"},
+        py::arg("method")              = "max_abs",
+        py::arg("per_channel_weights") = false);
 
 #ifdef HAVE_GPU
     m.def("allocate_gpu", &migraphx::gpu::allocate_gpu, py::arg("s"), py::arg("host") = false);
@@ -57,10 +57,7 @@ void quantize_fp16(program& prog, const std::vector<std::string>& ins_names)
     run_passes(prog, {optimize_module{}, quantize_fp16_pass{ins_names}, optimize_module{}});
 }
 
-void quantize_int8(program& prog,
-                   const target& t,
-                   const std::vector<parameter_map>& calibration,
-                   const std::vector<std::string>& ins_names)
+static void check_int8_ops(const std::vector<std::string>& ins_names)
 {
     std::set<std::string> op_names = {"convolution", "dot"};
     std::set<std::string> input_ins_names(ins_names.begin(), ins_names.end());
@@ -69,44 +66,28 @@ void quantize_int8(program& prog,
     {
         MIGRAPHX_THROW("QUANTIZE_INT8: only support DOT and CONVOLUTION operation");
     }
+}
 
-    std::shared_ptr<std::vector<std::pair<float, float>>> int8_quant_params =
-        std::make_shared<std::vector<std::pair<float, float>>>();
-    std::shared_ptr<std::vector<float>> max_abs_vals = std::make_shared<std::vector<float>>();
-
-    auto calc_quant_params = [int8_quant_params, max_abs_vals, &t](std::size_t ins_index,
-                                                                   std::vector<argument> args) {
-        std::pair<float, float> param_pair{64.0f, 0.0f};
-        // scale and shift is need for only int8 type, and we do not
-        // consider shift, so set shift to 0
-        std::vector<float> vec_val;
-        argument arg = t.copy_from(args.front());
-        arg.visit([&](auto output) { vec_val.assign(output.begin(), output.end()); });
-        auto max_val                = *std::max_element(vec_val.begin(), vec_val.end());
-        auto min_val                = *std::min_element(vec_val.begin(), vec_val.end());
-        auto max_abs                = std::max(std::fabs(max_val), std::fabs(min_val));
-        max_abs_vals->at(ins_index) = std::max(max_abs_vals->at(ins_index), max_abs);
-
-        // if all values are 0, no need to do scaling
-        if(max_abs_vals->at(ins_index) == 0.0f)
-        {
-            param_pair.first = 1.0f;
-        }
-        else
-        {
-            param_pair.first = 127.0f / max_abs_vals->at(ins_index);
-        }
-        int8_quant_params->at(ins_index) = param_pair;
+std::vector<std::pair<float, float>> calibrate_int8(const program& prog,
+                                                    const target& t,
+                                                    const std::vector<parameter_map>& calibration,
+                                                    const std::vector<std::string>& ins_names,
+                                                    const calibration_options& options)
+{
+    check_int8_ops(ins_names);
+
+    auto histograms    = std::make_shared<std::vector<calibration_histogram>>();
+    auto add_histogram = [histograms, &t](std::size_t ins_index, std::vector<argument> args) {
+        histograms->at(ins_index).add(t.copy_from(args.front()));
     };
 
     // pass to add capture argument op
+    auto capture_prog     = prog;
     std::size_t param_num = 0;
-    run_passes(prog, {capture_arguments_pass{ins_names, calc_quant_params, &param_num}});
-    int8_quant_params->resize(param_num, std::pair<float, float>(64.0f, 0.0f));
-    max_abs_vals->resize(param_num, 0.0f);
+    run_passes(capture_prog, {capture_arguments_pass{ins_names, add_histogram, &param_num}});
+    histograms->resize(param_num, calibration_histogram{options.bins});
 
     // use the calibration data to compute the quantization scale
-    auto capture_prog = prog;
     capture_prog.compile(t);
 
     // use all calibration data to run the program to calculate the
@@ -129,12 +110,37 @@ void quantize_int8(program& prog,
         capture_prog.eval(m);
     }
 
+    std::vector<std::pair<float, float>> quant_params;
+    std::transform(histograms->begin(),
+                   histograms->end(),
+                   std::back_inserter(quant_params),
+                   [&](const auto& h) { return h.quant_params(options); });
+    return quant_params;
+}
+
+void quantize_int8(program& prog,
+                   const std::vector<std::pair<float, float>>& quant_params,
+                   const std::vector<std::string>& ins_names,
+                   const calibration_options& options)
+{
+    check_int8_ops(ins_names);
+
+    // The captures are only used to number the inputs, they are replaced by the quantization
+    std::size_t param_num = 0;
+    run_passes(prog, {capture_arguments_pass{ins_names, {}, &param_num}});
+    if(param_num != quant_params.size())
+    {
+        MIGRAPHX_THROW("QUANTIZE_INT8: calibration table has " +
+                       std::to_string(quant_params.size()) + " entries but the program has " +
+                       std::to_string(param_num) + " inputs to quantize");
+    }
+
     // print the quantization parameters in only the main module
     if(enabled(MIGRAPHX_INT8_QUANTIZATION_PARAMS{}))
     {
-        for(std::size_t i = 0; i < int8_quant_params->size(); ++i)
+        for(std::size_t i = 0; i < quant_params.size(); ++i)
         {
-            auto param = int8_quant_params->at(i);
+            auto param = quant_params.at(i);
             std::cout << "ins_index = " << i << ", scale = " << param.first
                       << ", shift = " << param.second << std::endl;
         }
@@ -142,7 +148,7 @@ void quantize_int8(program& prog,
     }
 
     run_passes(prog,
-               {quantize_int8_pass{ins_names, *int8_quant_params},
+               {quantize_int8_pass{ins_names, quant_params, options.per_channel_weights},
                 eliminate_common_subexpression{},
                 dead_code_elimination{},
                 simplify_reshapes{},
@@ -151,5 +157,15 @@ void quantize_int8(program& prog,
                 dead_code_elimination{}});
 }
 
+void quantize_int8(program& prog,
+                   const target& t,
+                   const std::vector<parameter_map>& calibration,
+                   const std::vector<std::string>& ins_names,
+                   const calibration_options& options)
+{
+    quantize_int8(
+        prog, calibrate_int8(prog, t, calibration, ins_names, options), ins_names, options);
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -34,7 +34,10 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/target.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <cmath>
 #include <numeric>
 #include <set>
 
@@ -50,6 +53,41 @@ static std::vector<shape::type_t>& get_quantizable_type()
     return quantable_types;
 }
 
+// Returns the output channel axis when ins captures the constant weights of a convolution or dot
+static optional<std::size_t> weight_channel_axis(instruction_ref ins)
+{
+    auto input = ins->inputs().front();
+    if(not input->can_eval() or ins->outputs().size() != 1)
+        return nullopt;
+    auto op = ins->outputs().front();
+    if(op->inputs().size() < 2 or op->inputs()[1] != ins or op->inputs()[0] == ins)
+        return nullopt;
+    if(op->name() == "convolution")
+        return 0;
+    if(op->name() == "dot")
+        return input->get_shape().lens().size() - 1;
+    return nullopt;
+}
+
+// The quantizelinear scale of each channel along axis, from the max absolute value of the
+// channel
+static literal channel_scales(const argument& weights, std::size_t axis)
+{
+    const auto& s = weights.get_shape();
+    std::vector<double> max_abs(s.lens()[axis], 0.0);
+    weights.visit([&](auto w) {
+        shape_for_each(s, [&](const auto& idx) {
+            double x           = std::fabs(static_cast<double>(w(idx.begin(), idx.end())));
+            max_abs[idx[axis]] = std::max(max_abs[idx[axis]], x);
+        });
+    });
+    std::vector<double> scales;
+    std::transform(max_abs.begin(), max_abs.end(), std::back_inserter(scales), [](double x) {
+        return x == 0.0 ? 1.0 : x / 127.0;
+    });
+    return literal{shape{s.type(), {scales.size()}}, scales};
+}
+
 void quantize_int8_pass::apply(module& m) const // NOLINT
 {
     const auto& quantizable_types = get_quantizable_type();
@@ -69,10 +107,21 @@ void quantize_int8_pass::apply(module& m) const // NOLINT
         if(contains(quantizable_types, s.type()) and s.type() != shape::int8_type)
         {
             auto zero_point  = m.add_literal(static_cast<int8_t>(param.second));
-            auto scale       = m.add_literal(literal({s.type()}, {1.0f / param.first}));
             const auto& lens = s.lens();
-            scale =
-                m.insert_instruction(ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            auto axis        = per_channel_weights ? weight_channel_axis(ins) : nullopt;
+            instruction_ref scale;
+            if(axis)
+            {
+                scale = m.add_literal(channel_scales(input->eval(), *axis));
+                scale = m.insert_instruction(
+                    ins, make_op("broadcast", {{"axis", *axis}, {"out_lens", lens}}), scale);
+            }
+            else
+            {
+                scale = m.add_literal(literal({s.type()}, {1.0f / param.first}));
+                scale = m.insert_instruction(
+                    ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            }
             zero_point = m.insert_instruction(
                 ins, make_op("multibroadcast", {{"out_lens", lens}}), zero_point);
             auto q_in =
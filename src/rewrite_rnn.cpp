@@ -41,6 +41,7 @@
 #include <migraphx/op/common.hpp>
 #include <migraphx/op/rnn_var_sl_last_output.hpp>
 #include <migraphx/op/rnn_variable_seq_lens.hpp>
+#include <migraphx/op/rnn_sequence.hpp>
 #include <migraphx/make_op.hpp>
 
 #include <migraphx/iterator_for.hpp>
@@ -54,7 +55,11 @@ void rewrite_rnn::apply(module& m) const
 {
     for(auto ins : iterator_for(m))
     {
-        if(ins->name() == "rnn")
+        if(sequence and contains({"rnn", "gru", "lstm"}, ins->name()))
+        {
+            apply_sequence(m, ins);
+        }
+        else if(ins->name() == "rnn")
         {
             apply_vanilla_rnn(m, ins);
         }
@@ -69,6 +74,95 @@ void rewrite_rnn::apply(module& m) const
     }
 }
 
+void rewrite_rnn::apply_sequence(module& m, instruction_ref ins) const
+{
+    auto args = ins->inputs();
+
+    shape seq_shape         = args[0]->get_shape();
+    std::size_t num_dirs    = args[1]->get_shape().lens()[0];
+    std::size_t gate_size   = args[1]->get_shape().lens()[1];
+    std::size_t hidden_size = args[2]->get_shape().lens()[2];
+    std::size_t batch_size  = seq_shape.lens()[1];
+    shape::type_t type      = seq_shape.type();
+
+    op::rnn_sequence seq_op;
+    seq_op.cell = ins->name();
+    if(ins->name() == "rnn")
+    {
+        seq_op.direction  = any_cast<op::rnn>(ins->get_operator()).direction;
+        seq_op.actv_funcs = vanilla_rnn_actv_funcs(ins);
+    }
+    else if(ins->name() == "gru")
+    {
+        auto gru_op                = any_cast<op::gru>(ins->get_operator());
+        seq_op.direction           = gru_op.direction;
+        seq_op.linear_before_reset = gru_op.linear_before_reset;
+        seq_op.actv_funcs          = gru_actv_funcs(ins);
+    }
+    else
+    {
+        seq_op.direction  = any_cast<op::lstm>(ins->get_operator()).direction;
+        seq_op.actv_funcs = lstm_actv_funcs(ins);
+    }
+    // the unrolled cells ignore any extra activation functions
+    auto num_actv = num_dirs * seq_op.actv_count();
+    if(seq_op.actv_funcs.size() > num_actv)
+        seq_op.actv_funcs.erase(seq_op.actv_funcs.begin() + num_actv, seq_op.actv_funcs.end());
+
+    // missing inputs are passed as zeros, and missing sequence lengths as the full length
+    auto get_input = [&](std::size_t i, const shape& s) {
+        if(args.size() > i and not args[i]->is_undefined())
+        {
+            if(args[i]->get_shape().standard())
+                return args[i];
+            return m.insert_instruction(ins, make_op("contiguous"), args[i]);
+        }
+        return m.add_literal(literal{s, std::vector<float>(s.elements(), 0.0f)});
+    };
+    instruction_ref seq_lens{};
+    if(args.size() >= 5 and not args[4]->is_undefined())
+    {
+        seq_lens = args[4];
+    }
+    else
+    {
+        std::vector<int32_t> lens(batch_size, seq_shape.lens()[0]);
+        seq_lens = m.add_literal(literal{shape{shape::int32_type, {batch_size}}, lens});
+    }
+    shape ih_shape{type, {num_dirs, batch_size, hidden_size}};
+    std::vector<instruction_ref> inputs = {get_input(0, seq_shape),
+                                           get_input(1, args[1]->get_shape()),
+                                           get_input(2, args[2]->get_shape()),
+                                           get_input(3, shape{type, {num_dirs, 2 * gate_size}}),
+                                           seq_lens,
+                                           get_input(5, ih_shape)};
+    if(seq_op.is_lstm())
+    {
+        inputs.push_back(get_input(6, ih_shape));
+        inputs.push_back(get_input(7, shape{type, {num_dirs, 3 * hidden_size}}));
+    }
+
+    auto seq_ins = m.insert_instruction(ins, seq_op, inputs);
+    auto last_hs_output =
+        m.insert_instruction(ins, make_op("get_tuple_elem", {{"index", 1}}), seq_ins);
+    for(auto hs_out :
+        find_all(ins->outputs(), [&](auto i) { return i->name() == "rnn_last_hs_output"; }))
+    {
+        m.replace_instruction(hs_out, last_hs_output);
+    }
+    if(seq_op.is_lstm())
+    {
+        auto last_cell_output =
+            m.insert_instruction(ins, make_op("get_tuple_elem", {{"index", 2}}), seq_ins);
+        for(auto cell_out :
+            find_all(ins->outputs(), [&](auto i) { return i->name() == "rnn_last_cell_output"; }))
+        {
+            m.replace_instruction(cell_out, last_cell_output);
+        }
+    }
+    m.replace_instruction(ins, make_op("get_tuple_elem", {{"index", 0}}), seq_ins);
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 void rewrite_rnn::apply_vanilla_rnn(module& m, instruction_ref ins) const
 {
@@ -1489,36 +1489,34 @@ struct find_split_transpose
 
 void simplify_algebra::apply(module& m) const
 {
-    // Run simplifications multiple times
-    for(int i = 0; i < 8; i++)
-    {
-        match::find_matches(m,
-                            find_inner_broadcast{},
-                            find_dot_broadcast{},
-                            find_double_add_lit_broadcast{},
-                            find_add_lit_broadcast{},
-                            find_add_convs{},
-                            find_conv_dot_horiz_fusion{},
-                            find_mul_conv{},
-                            find_mul_slice_conv{},
-                            find_mul_dot{},
-                            find_dot_mul{},
-                            find_mul_add{},
-                            find_unit_ops{},
-                            find_neg_unit_ops{},
-                            find_zero_ops{},
-                            find_dot_add{},
-                            find_conv_add{},
-                            find_div_const{},
-                            find_sub_const{},
-                            find_rsqrt{},
-                            find_concat_op{},
-                            find_split_concat{},
-                            find_splits{},
-                            find_split_reshape{},
-                            find_split_transpose{});
-        dead_code_elimination{}.apply(m);
-    }
+    // Run simplifications until nothing changes
+    match::find_matches_fixpoint(m,
+                                 8,
+                                 find_inner_broadcast{},
+                                 find_dot_broadcast{},
+                                 find_double_add_lit_broadcast{},
+                                 find_add_lit_broadcast{},
+                                 find_add_convs{},
+                                 find_conv_dot_horiz_fusion{},
+                                 find_mul_conv{},
+                                 find_mul_slice_conv{},
+                                 find_mul_dot{},
+                                 find_dot_mul{},
+                                 find_mul_add{},
+                                 find_unit_ops{},
+                                 find_neg_unit_ops{},
+                                 find_zero_ops{},
+                                 find_dot_add{},
+                                 find_conv_add{},
+                                 find_div_const{},
+                                 find_sub_const{},
+                                 find_rsqrt{},
+                                 find_concat_op{},
+                                 find_split_concat{},
+                                 find_splits{},
+                                 find_split_reshape{},
+                                 find_split_transpose{});
+    dead_code_elimination{}.apply(m);
 }
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -27,6 +27,9 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/shape.hpp>
+#include <migraphx/float_equal.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/optional.hpp>
 #include <migraphx/matcher.hpp>
 #include <migraphx/dead_code_elimination.hpp>
 #include <migraphx/pass_manager.hpp>
@@ -45,17 +48,33 @@ std::unordered_set<std::string> get_quantizable_op_names()
     return s;
 }
 
-MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
+// Returns the value of the scale for each index along axis, read from the literal under its
+// broadcasts, or nothing when the scale is not a broadcast literal or also varies along the other
+// axes
+static optional<std::vector<double>> channel_scales(instruction_ref scale, std::size_t axis)
 {
-    if(ins->name() != "@literal")
-        return false;
-    bool all_same = false;
-    ins->get_literal().visit([&](auto s) {
-        all_same = std::all_of(s.begin() + 1, s.end(), [&](const auto& scale) {
-            return float_equal(scale, s.front());
-        });
+    auto lit = scale;
+    while(contains({"broadcast", "multibroadcast"}, lit->name()))
+        lit = lit->inputs().front();
+    const auto& s = scale->get_shape();
+    if(lit->name() != "@literal" or axis >= s.lens().size())
+        return nullopt;
+    for(std::size_t d = 0; d < s.lens().size(); d++)
+    {
+        if(d != axis and s.lens()[d] > 1 and s.strides()[d] != 0)
+            return nullopt;
+    }
+    std::vector<double> result(s.lens()[axis]);
+    lit->get_literal().visit([&](auto x) {
+        for(std::size_t c = 0; c < result.size(); c++)
+            result[c] = x.data()[c * s.strides()[axis]];
     });
-    return all_same;
+    return result;
+}
+
+static bool is_uniform(const std::vector<double>& v)
+{
+    return std::all_of(v.begin(), v.end(), [&](auto x) { return float_equal(x, v.front()); });
 }
 
 struct match_find_quantizable_ops
@@ -65,7 +84,7 @@ struct match_find_quantizable_ops
     {
         return match::name("dequantizelinear")(
             match::arg(0)(match::skip(match::name("quantizelinear"))(match::any().bind(name))),
-            match::arg(1)(match::skip_broadcasts(has_same_value().bind(scale))),
+            match::arg(1)(match::is_constant().bind(scale)),
             match::arg(2)(match::skip_broadcasts(match::all_of(match::has_value(0)))));
     }
 
@@ -89,9 +108,23 @@ struct match_find_quantizable_ops
            q2->get_shape().type() != migraphx::shape::int8_type)
             return;
 
-        double scale;
-        visit_all(scale1->get_literal(), scale2->get_literal())(
-            [&](const auto s1, const auto s2) { scale = s1.front() * s2.front(); });
+        // The weights can have a scale for each output channel, which is axis 0 of the
+        // convolution weights and the last axis of the second dot input. This becomes a scale
+        // for each channel of the output, applied when dequantizing the result.
+        bool is_conv  = qop->name() == "convolution";
+        auto w_axis   = is_conv ? 0 : q2->get_shape().lens().size() - 1;
+        auto out_axis = is_conv ? 1 : qop->get_shape().lens().size() - 1;
+        auto x_scales = channel_scales(scale1, 0);
+        auto w_scales = channel_scales(scale2, w_axis);
+        if(not x_scales or not w_scales)
+            return;
+        if(not is_uniform(*x_scales))
+            return;
+        std::vector<double> scales;
+        std::transform(w_scales->begin(),
+                       w_scales->end(),
+                       std::back_inserter(scales),
+                       [&](auto w) { return x_scales->front() * w; });
 
         auto qop_args  = qop->inputs();
         qop_args.at(0) = q1;
@@ -110,11 +143,20 @@ struct match_find_quantizable_ops
             dq = m.insert_instruction(qop, migraphx::make_op("quant_dot"), qop_args);
         }
         auto ins_type = qop->get_shape().type();
-        dq_scale      = m.add_literal(literal({ins_type}, {scale}));
-
-        auto lens = dq->get_shape().lens();
-        auto scale_mb =
-            m.insert_instruction(qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
+        auto lens     = dq->get_shape().lens();
+        instruction_ref scale_mb;
+        if(is_uniform(scales))
+        {
+            dq_scale = m.add_literal(literal({ins_type}, {scales.front()}));
+            scale_mb = m.insert_instruction(
+                qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
+        }
+        else
+        {
+            dq_scale = m.add_literal(literal({ins_type, {scales.size()}}, scales));
+            scale_mb = m.insert_instruction(
+                qop, make_op("broadcast", {{"axis", out_axis}, {"out_lens", lens}}), dq_scale);
+        }
         dq = m.insert_instruction(qop, make_op("dequantizelinear"), dq, scale_mb);
         m.replace_instruction(qop, dq);
     }
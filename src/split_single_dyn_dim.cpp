@@ -29,6 +29,8 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -39,6 +41,7 @@ struct dynamic_dimensions_check
     size_t dyn_index;
     size_t min_dim;
     size_t max_dim;
+    std::set<size_t> optimals;
 };
 
 optional<dynamic_dimensions_check>
@@ -65,7 +68,163 @@ has_one_dyn_dim(const std::unordered_map<std::string, shape>& param_shapes)
     return dynamic_dimensions_check{ps_it->first,
                                     static_cast<std::size_t>(std::distance(dds.begin(), dds_it)),
                                     dds_it->min,
-                                    dds_it->max};
+                                    dds_it->max,
+                                    dds_it->optimals};
+}
+
+/**
+ * The optimals within the range, or the powers of two when there are none, plus the max.
+ */
+std::vector<size_t> bucket_sizes(const dynamic_dimensions_check& ddc)
+{
+    std::vector<size_t> result;
+    if(ddc.optimals.empty())
+    {
+        size_t b = 1;
+        while(b < ddc.min_dim)
+            b *= 2;
+        for(; b < ddc.max_dim; b *= 2)
+            result.push_back(b);
+    }
+    else
+    {
+        std::copy_if(ddc.optimals.begin(),
+                     ddc.optimals.end(),
+                     std::back_inserter(result),
+                     [&](auto x) { return x >= ddc.min_dim and x < ddc.max_dim; });
+    }
+    result.push_back(ddc.max_dim);
+    return result;
+}
+
+/**
+ * The axis of `s` holding the dynamic dimension, when it is the only non-fixed dimension and has
+ * the range of the split dimension.
+ */
+optional<size_t> dyn_axis(const shape& s, const dynamic_dimensions_check& ddc)
+{
+    if(not s.dynamic())
+        return std::nullopt;
+    const auto& dds   = s.dyn_dims();
+    auto is_non_fixed = [](const auto& dd) { return not dd.is_fixed(); };
+    if(std::count_if(dds.begin(), dds.end(), is_non_fixed) != 1)
+        return std::nullopt;
+    auto it = std::find_if(dds.begin(), dds.end(), is_non_fixed);
+    if(it->min != ddc.min_dim or it->max != ddc.max_dim)
+        return std::nullopt;
+    return std::distance(dds.begin(), it);
+}
+
+/**
+ * Padding to a bucket is only valid when every output has the dynamic dimension at one axis,
+ * which the submodule for `dim_size` computes as `dim_size`.
+ */
+bool outputs_follow_dim(const std::vector<shape>& dyn_outputs,
+                        const module& submod,
+                        const dynamic_dimensions_check& ddc,
+                        size_t dim_size)
+{
+    auto outputs = submod.get_output_shapes();
+    if(outputs.size() != dyn_outputs.size())
+        return false;
+    return std::equal(dyn_outputs.begin(),
+                      dyn_outputs.end(),
+                      outputs.begin(),
+                      [&](const auto& ds, const auto& s) {
+                          auto axis = dyn_axis(ds, ddc);
+                          return axis.has_value() and s.lens().at(*axis) == dim_size;
+                      });
+}
+
+/**
+ * The axes an operator works across, normalized to `ndim`.
+ */
+std::vector<int64_t> op_axes(const operation& op, size_t ndim)
+{
+    auto v = op.to_value();
+    std::vector<int64_t> result;
+    if(v.contains("axes"))
+        result = v.at("axes").to_vector<int64_t>();
+    else if(v.contains("axis"))
+        result.push_back(v.at("axis").to<int64_t>());
+    std::transform(result.begin(), result.end(), result.begin(), [&](auto axis) {
+        return axis < 0 ? axis + static_cast<int64_t>(ndim) : axis;
+    });
+    return result;
+}
+
+/**
+ * True when the `arg`th input of `ins`, with the dynamic dimension at `in_axis`, is only used
+ * along that dimension element by element, ending up at `axis` of the output.
+ */
+bool follows_dyn_axis(instruction_ref ins, size_t arg, size_t in_axis, size_t axis)
+{
+    const auto& op = ins->get_operator();
+    auto in_ndim   = ins->inputs().at(arg)->get_shape().ndim();
+    auto out_ndim  = ins->get_shape().ndim();
+    if(op.attributes().contains("pointwise") or
+       contains({"contiguous", "convert", "identity", "multibroadcast"}, op.name()))
+        return in_axis + out_ndim == axis + in_ndim;
+    // Only size 1 axes are removed or added so the elements keep their order
+    if(contains({"squeeze", "unsqueeze"}, op.name()))
+        return true;
+    if(op.name() == "transpose")
+    {
+        auto perm = op.to_value().at("permutation").to_vector<int64_t>();
+        return perm.at(axis) == static_cast<int64_t>(in_axis);
+    }
+    if(contains({"softmax",
+                 "logsoftmax",
+                 "reduce_sum",
+                 "reduce_mean",
+                 "reduce_max",
+                 "reduce_min",
+                 "reduce_prod",
+                 "argmax",
+                 "argmin",
+                 "concat"},
+                op.name()))
+        return axis == in_axis and not contains(op_axes(op, in_ndim), in_axis);
+    // The dynamic dimension must not be the one contracted over
+    if(op.name() == "dot")
+        return axis == in_axis and in_axis + (arg == 0 ? 1 : 2) != in_ndim;
+    if(contains({"convolution", "quant_convolution", "pooling"}, op.name()))
+        return arg == 0 and in_axis == 0 and axis == 0;
+    return false;
+}
+
+/**
+ * Padding to a bucket is only valid when each element along the dynamic dimension is computed
+ * independently, so that the padded elements don't change the real ones. Every instruction using
+ * the dynamic parameter is checked to keep the dynamic dimension on one axis and not reduce or
+ * mix across it.
+ */
+bool computed_independently(const module& m, const dynamic_dimensions_check& ddc)
+{
+    std::unordered_map<instruction_ref, size_t> axes;
+    axes[m.get_parameter(ddc.dyn_param_str)] = ddc.dyn_index;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() == "@return")
+            continue;
+        std::vector<size_t> args;
+        for(size_t i = 0; i < ins->inputs().size(); i++)
+        {
+            if(contains(axes, ins->inputs()[i]))
+                args.push_back(i);
+        }
+        if(args.empty())
+            continue;
+        auto axis = dyn_axis(ins->get_shape(), ddc);
+        if(not axis.has_value())
+            return false;
+        if(not std::all_of(args.begin(), args.end(), [&](auto i) {
+               return follows_dyn_axis(ins, i, axes.at(ins->inputs()[i]), *axis);
+           }))
+            return false;
+        axes[ins] = *axis;
+    }
+    return true;
 }
 
 namespace {
@@ -121,11 +280,8 @@ void split_single_dyn_dim::apply(module_pass_manager& mpm) const
     {
         const auto& dyn_param = mm->get_parameter(dd_check->dyn_param_str);
         auto dyn_param_shape  = mm->get_parameter_shape(dd_check->dyn_param_str);
-        std::vector<module_ref> submodules;
-        // create submodules for each dimension size
-        for(size_t dim_size : migraphx::range(dd_check->min_dim, dd_check->max_dim + 1))
-        {
-            auto* submod = mpm.create_module("dim_" + std::to_string(dim_size));
+        auto make_submodule = [&](size_t dim_size, const std::string& name) {
+            auto* submod = mpm.create_module(name + std::to_string(dim_size));
             // instruction map for new static shaped submodule parameters
             std::unordered_map<instruction_ref, instruction_ref> map_ins;
             // create static shape using dim_size
@@ -136,9 +292,36 @@ void split_single_dyn_dim::apply(module_pass_manager& mpm) const
             auto outputs = submod->add_instructions(mm, map_ins);
             submod->add_return({outputs});
             match::find_matches(*submod, find_static_2in_broadcasts{});
-            submodules.push_back(submod);
+            return submod;
+        };
+        std::vector<module_ref> submodules;
+        bool padded = false;
+        if(bucket and computed_independently(*mm, *dd_check))
+        {
+            // create submodules for each bucket, unless the outputs can't be sliced back
+            auto dyn_outputs = mm->get_output_shapes();
+            for(size_t dim_size : bucket_sizes(*dd_check))
+            {
+                auto* submod = make_submodule(dim_size, "bucket_");
+                if(not outputs_follow_dim(dyn_outputs, *submod, *dd_check, dim_size))
+                {
+                    // The unused bucket submodules are removed by dead_code_elimination
+                    submodules.clear();
+                    break;
+                }
+                submodules.push_back(submod);
+            }
+            padded = not submodules.empty();
+        }
+        if(submodules.empty())
+        {
+            // create submodules for each dimension size
+            for(size_t dim_size : migraphx::range(dd_check->min_dim, dd_check->max_dim + 1))
+                submodules.push_back(make_submodule(dim_size, "dim_"));
         }
-        // redirect to select_module operator and return
+        // redirect to select_module operator and return, select_module takes the inputs in the
+        // sorted order of the submodule parameter names
+        std::sort(param_names.begin(), param_names.end());
         std::vector<instruction_ref> sm_inputs;
         std::transform(param_names.cbegin(),
                        param_names.cend(),
@@ -148,7 +331,8 @@ void split_single_dyn_dim::apply(module_pass_manager& mpm) const
         migraphx::shape out_attr = migraphx::shape{output_shapes};
         auto sm_ins              = mm->add_instruction(
             migraphx::make_op("select_module",
-                              {{"output_dyn_shapes", migraphx::to_value(out_attr)}}),
+                              {{"output_dyn_shapes", migraphx::to_value(out_attr)},
+                               {"pad_to_bucket", padded}}),
             sm_inputs,
             submodules);
         std::vector<instruction_ref> outputs(output_shapes.size());
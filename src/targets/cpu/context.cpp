@@ -0,0 +1,212 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+stream::stream() : thread([this] { this->run(); }) {}
+
+stream::~stream()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+    thread.join();
+}
+
+void stream::execute(std::function<void()> f)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(f));
+        pending++;
+    }
+    cv.notify_all();
+}
+
+void stream::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return pending == 0; });
+    if(error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+std::exception_ptr stream::take_error()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::exchange(error, nullptr);
+}
+
+void stream::run()
+{
+    for(;;)
+    {
+        std::function<void()> f;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return stop or not tasks.empty(); });
+            if(tasks.empty())
+                return;
+            f = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        // Keep running the remaining tasks after a failure so any events they
+        // record are still completed and waiters cant deadlock
+        std::exception_ptr e;
+        try
+        {
+            f();
+        }
+        catch(...)
+        {
+            e = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(e and not error)
+                error = e;
+            pending--;
+        }
+        cv.notify_all();
+    }
+}
+
+std::size_t event::issue_record()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return ++issued;
+}
+
+std::size_t event::last_record() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return issued;
+}
+
+void event::complete(std::size_t n, std::exception_ptr e)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed = std::max(completed, n);
+        if(e and not error)
+            error = std::move(e);
+    }
+    cv.notify_all();
+}
+
+void event::wait(std::size_t n)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return completed >= n; });
+    if(error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+void event::clear_error()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    error = nullptr;
+}
+
+stream& context::get_stream(std::size_t n)
+{
+    assert(n > 0 and n < nstreams);
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if(state->streams.size() < n)
+        state->streams.resize(n);
+    auto& s = state->streams[n - 1];
+    if(s == nullptr)
+        s = std::make_unique<stream>();
+    return *s;
+}
+
+event& context::get_event(std::size_t n)
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if(state->events.size() <= n)
+        state->events.resize(n + 1);
+    auto& e = state->events[n];
+    if(e == nullptr)
+        e = std::make_unique<event>();
+    return *e;
+}
+
+void context::finish() const
+{
+    std::vector<stream*> streams;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for(const auto& s : state->streams)
+        {
+            if(s != nullptr)
+                streams.push_back(s.get());
+        }
+    }
+    for(auto* s : streams)
+        s->wait();
+}
+
+void context::drain() const
+{
+    std::vector<stream*> streams;
+    std::vector<event*> events;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for(const auto& s : state->streams)
+        {
+            if(s != nullptr)
+                streams.push_back(s.get());
+        }
+        for(const auto& e : state->events)
+        {
+            if(e != nullptr)
+                events.push_back(e.get());
+        }
+    }
+    for(auto* s : streams)
+    {
+        try
+        {
+            s->wait();
+        }
+        catch(...)
+        {
+            // Only the error that stopped the run is reported
+        }
+    }
+    for(auto* e : events)
+        e->clear_error();
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
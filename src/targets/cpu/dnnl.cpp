@@ -49,7 +49,10 @@ namespace cpu {
 
 dnnl_context& get_dnnl_context()
 {
-    static dnnl_context ctx{}; // NOLINT
+    static dnnl_context global_ctx{}; // NOLINT
+    // Streams can't be shared between threads, so the threads running the
+    // scheduler's streams each get their own stream on the same engine
+    thread_local dnnl_context ctx{global_ctx.engine}; // NOLINT
     return ctx;
 }
 
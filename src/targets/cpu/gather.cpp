@@ -25,6 +25,7 @@
 #include <migraphx/context.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/op/gather.hpp>
+#include <migraphx/shape_for_each.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -55,20 +56,26 @@ struct cpu_gather : auto_register_op<cpu_gather>
         auto lens             = args[0].get_shape().lens();
         auto axis_dim_size    = lens[op.axis];
         lens[op.axis]         = args[1].get_shape().elements();
-        shape out_comp{output_shape.type(), lens};
+        auto in_strides       = args[0].get_shape().strides();
+        auto axis_stride      = in_strides[op.axis];
+        in_strides[op.axis]   = 0;
+        shape out_comp{output_shape.type(), lens, in_strides};
 
         visit_all(args.back(), args[0])([&](auto output, auto input) {
             args[1].visit([&](auto indices) {
                 const auto* indices_ptr = indices.data();
+                const auto* input_ptr   = input.data();
                 auto* output_ptr        = output.data();
                 ctx.bulk_execute(nelements, 1024, [=](auto start, auto end) {
-                    for(auto i = start; i < end; i++)
+                    // Each chunk starts its index mid-tensor and then advances it, the offset
+                    // tracks every axis of the input except the gathered one
+                    shape_index it{out_comp, start};
+                    for(auto i = start; i < end; i++, ++it)
                     {
-                        auto idx      = out_comp.multi(i);
-                        auto in_index = indices_ptr[idx[op.axis]];
+                        auto in_index = indices_ptr[it.multi()[op.axis]];
                         in_index      = (in_index < 0) ? in_index + axis_dim_size : in_index;
-                        idx[op.axis]  = in_index;
-                        output_ptr[i] = input(idx.begin(), idx.end());
+                        output_ptr[i] = input_ptr[it.offset() +
+                                                  static_cast<std::size_t>(in_index) * axis_stride];
                     }
                 });
             });
@@ -25,18 +25,105 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/env.hpp>
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/value.hpp>
 #include <migraphx/cpu/export.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_STREAMS)
+
+/// A worker thread that runs tasks in the order they were submitted
+struct stream
+{
+    stream();
+    stream(const stream&)            = delete;
+    stream& operator=(const stream&) = delete;
+    ~stream();
+
+    void execute(std::function<void()> f);
+    /// Block until every submitted task has finished, rethrowing the first
+    /// exception thrown by a task
+    void wait();
+    /// Take the first exception thrown by a task so far, so it can be passed
+    /// on to whoever waits for this stream's work through an event
+    std::exception_ptr take_error();
+
+    private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::size_t pending = 0;
+    bool stop           = false;
+    std::exception_ptr error;
+    std::thread thread;
+};
+
+/// Records are numbered when they are issued, so a wait only blocks on the
+/// records issued before it and the event never has to be reset between runs.
+/// A record can carry an exception from the recording stream, which is
+/// rethrown by the next wait.
+struct event
+{
+    std::size_t issue_record();
+    std::size_t last_record() const;
+    void complete(std::size_t n, std::exception_ptr e = nullptr);
+    void wait(std::size_t n);
+    void clear_error();
+
+    private:
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t issued    = 0;
+    std::size_t completed = 0;
+    std::exception_ptr error;
+};
+
 struct context
 {
-    void finish() const {}
+    context(std::size_t n = value_of(MIGRAPHX_CPU_STREAMS{}, 1)) : nstreams(n) {}
+
+    std::size_t get_nstreams() const { return nstreams; }
+
+    /// The stream count decides how the program is scheduled, so it is kept
+    /// with the compiled program
+    value to_value() const
+    {
+        value result;
+        result["streams"] = nstreams;
+        return result;
+    }
+
+    void from_value(const value& v)
+    {
+        if(v.contains("streams"))
+            nstreams = v.at("streams").to<std::size_t>();
+    }
+
+    /// Stream 0 is the thread evaluating the program, so only the streams
+    /// after it have a worker
+    stream& get_stream(std::size_t n);
+    event& get_event(std::size_t n);
+
+    void finish() const;
+    /// Wait for every stream and drop any errors still held by the streams
+    /// and events, so a failed run leaves nothing behind for the next one
+    void drain() const;
 
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
@@ -49,6 +136,16 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    private:
+    struct shared_state
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<stream>> streams;
+        std::vector<std::unique_ptr<event>> events;
+    };
+    std::size_t nstreams                = 1;
+    std::shared_ptr<shared_state> state = std::make_shared<shared_state>();
 };
 
 } // namespace cpu
@@ -55,6 +55,7 @@ struct dnnl_context
     dnnl::engine engine;
     dnnl::stream stream;
     dnnl_context() : engine(dnnl::engine::kind::cpu, 0), stream(engine) {}
+    explicit dnnl_context(const dnnl::engine& e) : engine(e), stream(e) {}
 };
 
 dnnl_context& get_dnnl_context();
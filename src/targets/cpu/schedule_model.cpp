@@ -0,0 +1,246 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/stringutils.hpp>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Rethrow an error from the streams once their queued work is done, so
+// nothing is left to fail the next run
+template <class F>
+static void drain_on_error(context& ctx, F f)
+{
+    try
+    {
+        f();
+    }
+    catch(...)
+    {
+        ctx.drain();
+        throw;
+    }
+}
+
+// Runs the operator on the worker for its stream. Operators that write into
+// their last input can be queued, since the result is known before they run.
+// Any other operator waits for its stream and then runs on the calling thread.
+struct stream_op
+{
+    operation op;
+    std::size_t stream = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.op, "op"), f(self.stream, "stream"));
+    }
+
+    std::string name() const { return "cpu::stream"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        return op.compute_shape(std::move(inputs));
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
+
+    void finalize(migraphx::context& ctx, const shape& output, const std::vector<shape>& inputs)
+    {
+        op.finalize(ctx, output, inputs);
+    }
+
+    argument
+    compute(migraphx::context& ctx, const shape& output, const std::vector<argument>& args) const
+    {
+        auto& s = any_cast<context>(ctx).get_stream(stream);
+        if(args.empty() or args.back().get_shape() != output or
+           op.output_alias(to_shapes(args)) != std::ptrdiff_t(args.size()) - 1)
+        {
+            drain_on_error(any_cast<context>(ctx), [&] { s.wait(); });
+            return op.compute(ctx, output, args);
+        }
+        s.execute([this, &ctx, output, args] { op.compute(ctx, output, args); });
+        return args.back();
+    }
+};
+
+struct record_event
+{
+    std::size_t event  = 0;
+    std::size_t stream = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"), f(self.stream, "stream"));
+    }
+
+    std::string name() const { return "cpu::record_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        auto& e = ctx.get_event(event);
+        auto n  = e.issue_record();
+        if(stream == 0)
+        {
+            e.complete(n);
+        }
+        else
+        {
+            // Pass a failure of the work before the record on to the waiters,
+            // a failing wait on a worker is passed on by its own records
+            auto& s = ctx.get_stream(stream);
+            s.execute([&e, &s, n] { e.complete(n, s.take_error()); });
+        }
+        return {};
+    }
+};
+
+struct wait_event
+{
+    std::size_t event  = 0;
+    std::size_t stream = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"), f(self.stream, "stream"));
+    }
+
+    std::string name() const { return "cpu::wait_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        auto& e = ctx.get_event(event);
+        // Only wait for the records issued so far in this run
+        auto n = e.last_record();
+        if(stream == 0)
+            drain_on_error(ctx, [&] { e.wait(n); });
+        else
+            ctx.get_stream(stream).execute([&e, n] { e.wait(n); });
+        return {};
+    }
+};
+
+struct sync_stream
+{
+    std::size_t stream = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.stream, "stream"));
+    }
+
+    std::string name() const { return "cpu::sync_stream"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        drain_on_error(ctx, [&] { ctx.get_stream(stream).wait(); });
+        return {};
+    }
+};
+
+MIGRAPHX_REGISTER_OP(stream_op)
+MIGRAPHX_REGISTER_OP(record_event)
+MIGRAPHX_REGISTER_OP(wait_event)
+MIGRAPHX_REGISTER_OP(sync_stream)
+
+// The stream the instruction runs on, where unwrapped instructions run on the
+// calling thread
+static std::size_t get_stream(instruction_ref ins)
+{
+    if(ins->name() != "cpu::stream")
+        return 0;
+    return any_cast<stream_op>(ins->get_operator()).stream;
+}
+
+std::size_t schedule_model::concurrency() const { return streams; }
+
+void schedule_model::sched(module& m, instruction_ref ins, std::size_t n) const
+{
+    if(n == 0)
+        return;
+    // Builtins and operators with submodules can't be wrapped, so they run
+    // on the calling thread after the earlier work on their stream
+    if(starts_with(ins->name(), "@") or not ins->module_inputs().empty())
+    {
+        m.insert_instruction(ins, sync_stream{n});
+        return;
+    }
+    m.replace_instruction(ins, stream_op{ins->get_operator(), n}, ins->inputs());
+}
+
+void schedule_model::wait(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(ins, wait_event{wait_id, get_stream(ins)});
+}
+
+void schedule_model::record(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(std::next(ins), record_event{wait_id, get_stream(ins)});
+}
+
+static std::unordered_map<std::string, std::size_t> create_weight_map()
+{
+    return {{"cpu::allocate", 0},
+            {"cpu::literal", 0},
+            {"cpu::preallocate", 0},
+            {"dnnl::convolution", 8},
+            {"dnnl::convolution_backwards", 8},
+            {"dnnl::pooling", 4},
+            {"dnnl::dot", 4}};
+}
+
+static const std::unordered_map<std::string, std::size_t>& weight_map()
+{
+    static const std::unordered_map<std::string, std::size_t> m = create_weight_map();
+    return m;
+}
+
+std::size_t schedule_model::weight(const operation& op) const
+{
+    if(weight_map().count(op.name()) == 0)
+    {
+        return 2;
+    }
+    return weight_map().at(op.name());
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
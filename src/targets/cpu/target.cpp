@@ -25,6 +25,7 @@
 #include <migraphx/auto_contiguous.hpp>
 #include <migraphx/adjust_allocation.hpp>
 #include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/deduplicate_literals.hpp>
 #include <migraphx/eliminate_allocation.hpp>
 #include <migraphx/eliminate_common_subexpression.hpp>
 #include <migraphx/eliminate_concat.hpp>
@@ -51,6 +52,7 @@
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/cpu/lowering.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
@@ -59,6 +61,10 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_SCHEDULE_PASS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_RNN_SEQUENCE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_BEST_FIT_MEMORY)
+
 std::string target::name() const { return "cpu"; }
 
 // cppcheck-suppress constParameterReference
@@ -76,19 +82,18 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             eliminate_identity{},
             eliminate_pad{},
             dead_code_elimination{},
-            rewrite_rnn{},
+            rewrite_rnn{enabled(MIGRAPHX_ENABLE_RNN_SEQUENCE{})},
             dead_code_elimination{},
             eliminate_common_subexpression{},
             dead_code_elimination{},
             simplify_algebra{},
             simplify_reshapes{},
             dead_code_elimination{},
-            simplify_reshapes{},
-            simplify_algebra{},
             auto_contiguous{},
             simplify_reshapes{},
             propagate_constant{},
             dead_code_elimination{},
+            deduplicate_literals{},
             lowering{},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
@@ -100,7 +105,10 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             write_literals{},
             dead_code_elimination{},
-            memory_coloring{"cpu::allocate"},
+            schedule{cpu::schedule_model{ctx.get_nstreams()},
+                     not enabled(MIGRAPHX_DISABLE_SCHEDULE_PASS{})},
+            memory_coloring{
+                "cpu::allocate", false, enabled(MIGRAPHX_ENABLE_BEST_FIT_MEMORY{})},
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
             dead_code_elimination{}};
@@ -26,6 +26,7 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/register_op.hpp>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -57,11 +58,27 @@ MIGRAPHX_REGISTER_OP(cpu_literal);
 
 void write_literals::apply(module& m) const
 {
+    // Literals that share a buffer also share the copy of it
+    std::unordered_map<const char*, argument> copies;
     for(auto ins : iterator_for(m))
     {
         if(ins->name() != "@literal")
             continue;
-        m.replace_instruction(ins, cpu_literal{ins->get_literal().get_argument()});
+        const auto& l = ins->get_literal();
+        if(l.empty())
+        {
+            m.replace_instruction(ins, cpu_literal{l.get_argument()});
+            continue;
+        }
+        auto it = copies.find(l.data());
+        if(it == copies.end())
+            it = copies.emplace(l.data(), l.get_argument()).first;
+        auto a = it->second;
+        if(a.get_shape().bytes() < l.get_shape().bytes())
+            a = l.get_argument();
+        else if(a.get_shape() != l.get_shape())
+            a = argument{l.get_shape(), [a] { return a.data(); }};
+        m.replace_instruction(ins, cpu_literal{a});
     }
 }
 
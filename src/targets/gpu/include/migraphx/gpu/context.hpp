@@ -262,6 +262,7 @@ struct context
         value result;
         result["events"]  = events.size();
         result["streams"] = current_device->nstreams();
+        result["device"]  = current_device->get_device_name();
 
         return result;
     }
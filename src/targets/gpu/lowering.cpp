@@ -369,6 +369,9 @@ struct miopen_apply
     void add_select_module_op()
     {
         apply_map.emplace("select_module", [=](instruction_ref ins) {
+            // Padding to a bucket copies through host memory
+            if(ins->get_operator().to_value().get("pad_to_bucket", false))
+                MIGRAPHX_THROW("select_module: padding to a bucket is not supported on gpu");
             auto s                              = ins->get_shape();
             auto output                         = insert_allocation(ins, s);
             std::vector<instruction_ref> inputs = ins->inputs();
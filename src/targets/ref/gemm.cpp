@@ -25,7 +25,11 @@
 #include <migraphx/dfor.hpp>
 #include <migraphx/requires.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/half.hpp>
 #include <blaze/math/CustomMatrix.h>
+#include <array>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -97,21 +101,242 @@ void migemm_impl(
     assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
     assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
     assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
-
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += amat(a_idx.begin(), a_idx.end()) * bmat(b_idx.begin(), b_idx.end());
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+    auto cs        = cmat.get_shape();
+    const auto& as = amat.get_shape();
+    const auto& bs = bmat.get_shape();
+    auto a_stride  = as.strides()[dim_1];
+    auto b_stride  = bs.strides()[dim_0];
+
+    par_shape_for_each(cs, [&](const auto& c_idx) {
+        // The row of a and the column of b share the index of c except along k. The offsets
+        // are computed as integers first since c's index can be past the end of a or b.
+        std::size_t a_offset = as.index(c_idx) - c_idx[dim_1] * a_stride;
+        std::size_t b_offset = bs.index(c_idx) - c_idx[dim_0] * b_stride;
+        const T* a           = amat.data() + a_offset;
+        const T* b           = bmat.data() + b_offset;
+        double s             = 0.0;
+        dfor(k)([&](auto kk) { s += a[kk * a_stride] * b[kk * b_stride]; });
+        auto& c = cmat(c_idx.begin(), c_idx.end());
+        c       = alpha * s + c * beta;
     });
 }
 
+// Types that are computed with the packed gemm, the accumulator type is
+// used for the packed panels and the micro-kernel
+template <class T>
+struct packed_gemm_accumulator
+{
+};
+
+template <>
+struct packed_gemm_accumulator<float>
+{
+    using type = float;
+};
+
+template <>
+struct packed_gemm_accumulator<double>
+{
+    using type = double;
+};
+
+template <>
+struct packed_gemm_accumulator<half>
+{
+    using type = float;
+};
+
+template <>
+struct packed_gemm_accumulator<int8_t>
+{
+    using type = int32_t;
+};
+
+template <>
+struct packed_gemm_accumulator<int32_t>
+{
+    using type = int32_t;
+};
+
+template <class T, class = void>
+struct is_packed_gemm_type : std::false_type
+{
+};
+
+template <class T>
+struct is_packed_gemm_type<T, std::void_t<typename packed_gemm_accumulator<T>::type>>
+    : std::true_type
+{
+};
+
+// Size of the register block computed by the micro-kernel
+constexpr std::size_t gemm_mr = 4;
+constexpr std::size_t gemm_nr = 8;
+
+// Strides and sizes of the last two dimensions of a tensor, and the offset of
+// each batch
+struct gemm_matrix
+{
+    std::size_t rows       = 0;
+    std::size_t cols       = 0;
+    std::size_t row_stride = 0;
+    std::size_t col_stride = 0;
+    std::vector<std::size_t> batch_offsets;
+
+    explicit gemm_matrix(const shape& s)
+    {
+        const auto& lens    = s.lens();
+        const auto& strides = s.strides();
+        auto n_dims         = lens.size();
+        rows                = lens[n_dims - 2];
+        cols                = lens[n_dims - 1];
+        row_stride          = strides[n_dims - 2];
+        col_stride          = strides[n_dims - 1];
+        batch_offsets.resize(std::accumulate(lens.begin(),
+                                             lens.end() - 2,
+                                             std::size_t{1},
+                                             std::multiplies<std::size_t>{}));
+        for(std::size_t b = 0; b < batch_offsets.size(); b++)
+        {
+            std::size_t offset = 0;
+            std::size_t idx    = b;
+            for(std::size_t d = n_dims - 2; d > 0; d--)
+            {
+                offset += (idx % lens[d - 1]) * strides[d - 1];
+                idx /= lens[d - 1];
+            }
+            batch_offsets[b] = offset;
+        }
+    }
+
+    bool is_batch_broadcasted() const
+    {
+        return std::all_of(
+            batch_offsets.begin(), batch_offsets.end(), [](auto x) { return x == 0; });
+    }
+};
+
+// Pack B into panels of gemm_nr columns, where each panel stores the k rows
+// contiguously and the last panel is padded with zeros
+template <class Acc, class T>
+void pack_b_panels(std::vector<Acc>& packed, const T* b, const gemm_matrix& bm)
+{
+    const std::size_t k      = bm.rows;
+    const std::size_t n      = bm.cols;
+    const std::size_t panels = (n + gemm_nr - 1) / gemm_nr;
+    const std::size_t psize  = k * gemm_nr;
+    packed.resize(panels * psize);
+    par_for(panels, 1, [&](std::size_t p) {
+        auto* dst      = packed.data() + p * psize;
+        std::size_t j0 = p * gemm_nr;
+        std::size_t nj = std::min(gemm_nr, n - j0);
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            const T* src = b + kk * bm.row_stride + j0 * bm.col_stride;
+            for(std::size_t j = 0; j < nj; j++)
+                dst[kk * gemm_nr + j] = static_cast<Acc>(src[j * bm.col_stride]);
+            for(std::size_t j = nj; j < gemm_nr; j++)
+                dst[kk * gemm_nr + j] = Acc{0};
+        }
+    });
+}
+
+// Pack gemm_mr rows of A so each column of the block is contiguous
+template <class Acc, class T>
+void pack_a_block(Acc* dst, const T* a, const gemm_matrix& am, std::size_t i0)
+{
+    const std::size_t k  = am.cols;
+    const std::size_t ni = std::min(gemm_mr, am.rows - i0);
+    for(std::size_t kk = 0; kk < k; kk++)
+    {
+        const T* src = a + i0 * am.row_stride + kk * am.col_stride;
+        for(std::size_t i = 0; i < ni; i++)
+            dst[kk * gemm_mr + i] = static_cast<Acc>(src[i * am.row_stride]);
+        for(std::size_t i = ni; i < gemm_mr; i++)
+            dst[kk * gemm_mr + i] = Acc{0};
+    }
+}
+
+// Compute a gemm_mr x gemm_nr block of the product in registers
+template <class Acc>
+void gemm_micro_kernel(std::size_t k,
+                       const Acc* pa,
+                       const Acc* pb,
+                       std::array<std::array<Acc, gemm_nr>, gemm_mr>& acc)
+{
+    for(auto& row : acc)
+        row.fill(Acc{0});
+    for(std::size_t kk = 0; kk < k; kk++)
+    {
+        const Acc* a = pa + kk * gemm_mr;
+        const Acc* b = pb + kk * gemm_nr;
+        for(std::size_t i = 0; i < gemm_mr; i++)
+        {
+            for(std::size_t j = 0; j < gemm_nr; j++)
+                acc[i][j] += a[i] * b[j];
+        }
+    }
+}
+
+// Packed gemm with register blocking. B is packed once per batch, or only once
+// when it is broadcasted across the batch, and each thread packs its own block of
+// rows of A.
+template <class TC, class T, class F>
+void packed_gemm(tensor_view<TC> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta)
+{
+    using acc_type = typename packed_gemm_accumulator<T>::type;
+    gemm_matrix am{amat.get_shape()};
+    gemm_matrix bm{bmat.get_shape()};
+    gemm_matrix cm{cmat.get_shape()};
+    assert(am.cols == bm.rows);
+    assert(cm.rows == am.rows);
+    assert(cm.cols == bm.cols);
+
+    const std::size_t k        = am.cols;
+    const std::size_t n        = bm.cols;
+    const std::size_t m_blocks = (am.rows + gemm_mr - 1) / gemm_mr;
+    const std::size_t n_panels = (n + gemm_nr - 1) / gemm_nr;
+    const std::size_t nbatch   = cm.batch_offsets.size();
+    const bool reuse_b         = bm.is_batch_broadcasted();
+
+    std::vector<acc_type> packed_b;
+    std::vector<std::vector<acc_type>> packed_a(
+        std::max<std::size_t>(1, get_thread_pool().size()),
+        std::vector<acc_type>(k * gemm_mr));
+    for(std::size_t batch = 0; batch < nbatch; batch++)
+    {
+        if(batch == 0 or not reuse_b)
+            pack_b_panels(packed_b, bmat.data() + bm.batch_offsets[batch], bm);
+        const T* a = amat.data() + am.batch_offsets[batch];
+        TC* c      = cmat.data() + cm.batch_offsets[batch];
+        par_for(m_blocks, 1, [&](std::size_t mb, std::size_t tid) {
+            auto* pa = packed_a[tid].data();
+            auto i0  = mb * gemm_mr;
+            auto ni  = std::min(gemm_mr, am.rows - i0);
+            pack_a_block(pa, a, am, i0);
+            std::array<std::array<acc_type, gemm_nr>, gemm_mr> acc;
+            for(std::size_t p = 0; p < n_panels; p++)
+            {
+                gemm_micro_kernel(k, pa, packed_b.data() + p * k * gemm_nr, acc);
+                auto j0 = p * gemm_nr;
+                auto nj = std::min(gemm_nr, n - j0);
+                for(std::size_t i = 0; i < ni; i++)
+                {
+                    for(std::size_t j = 0; j < nj; j++)
+                    {
+                        auto& y = c[(i0 + i) * cm.row_stride + (j0 + j) * cm.col_stride];
+                        // Dont read the output when beta is zero
+                        if(beta == 0)
+                            y = alpha * acc[i][j];
+                        else
+                            y = alpha * acc[i][j] + beta * y;
+                    }
+                }
+            }
+        });
+    }
+}
+
 template <class T, class F>
 void migemm_impl(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta)
 {
@@ -119,10 +344,14 @@ void migemm_impl(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat,
     bool batch_mul =
         std::accumulate(
             lens.rbegin() + 2, lens.rend(), std::size_t{1}, std::multiplies<std::size_t>()) == 1;
-    if(batch_mul)
+    if(batch_mul and is_fast_gemm_type<T>{})
     {
         migemm_impl(cmat, amat, bmat, alpha, beta, is_fast_gemm_type<T>{});
     }
+    else if constexpr(is_packed_gemm_type<T>{})
+    {
+        packed_gemm(cmat, amat, bmat, alpha, beta);
+    }
     else
     {
         migemm_impl(cmat, amat, bmat, alpha, beta, std::false_type{});
@@ -149,7 +378,13 @@ void migemm(const argument& c_arg,
             int32_t alpha,
             int32_t beta)
 {
-    migemm_tpl(c_arg, a_arg, b_arg, alpha, beta);
+    // int8 inputs are accumulated into the int32 output without converting them first
+    if(a_arg.get_shape().type() == shape::int8_type and
+       b_arg.get_shape().type() == shape::int8_type and
+       c_arg.get_shape().type() == shape::int32_type)
+        packed_gemm(c_arg.get<int32_t>(), a_arg.get<int8_t>(), b_arg.get<int8_t>(), alpha, beta);
+    else
+        migemm_tpl(c_arg, a_arg, b_arg, alpha, beta);
 }
 
 } // namespace ref
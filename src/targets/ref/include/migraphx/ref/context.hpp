@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/buffer_arena.hpp>
 #include <migraphx/ref/export.h>
 
 namespace migraphx {
@@ -34,6 +35,10 @@ namespace ref {
 struct context
 {
     void finish() const {}
+
+    // Results of the ref operators are allocated from here so they are reused between runs. The
+    // free buffers are released when the last copy of the context is destroyed.
+    buffer_arena arena;
 };
 
 } // namespace ref
@@ -40,8 +40,12 @@
 #include <migraphx/op/argmax.hpp>
 #include <migraphx/op/argmin.hpp>
 #include <migraphx/op/rnn_var_sl_last_output.hpp>
+#include <migraphx/op/pointwise.hpp>
+#include <migraphx/host_pointwise.hpp>
+#include <migraphx/env.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/clamp.hpp>
 #include <migraphx/ref/gemm.hpp>
@@ -84,8 +88,10 @@ struct ref_lrn
 
     std::string name() const { return "ref::lrn"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, shape output_shape, std::vector<argument> args) const
+    argument compute(context& ctx, shape output_shape, std::vector<argument> args) const
     {
+        // Every element of the result is written
+        buffer_arena_scope scope{ctx.arena, false};
         argument result{output_shape};
         visit_all(result, args[0])([&](auto output, auto input) {
             int n_batch         = output_shape.lens()[0];
@@ -148,8 +154,10 @@ struct ref_im2col
         return op.normalize_compute_shape(inputs);
     }
 
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
     {
+        // Every element of the result is written
+        buffer_arena_scope scope{ctx.arena, false};
         argument result{output_shape};
         auto input_shape   = args[0].get_shape();
         auto weights_shape = args[1].get_shape();
@@ -208,8 +216,10 @@ struct ref_op
     }
     std::string name() const { return "ref::op"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const shape& output_shape, const std::vector<argument>& args) const
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
+        buffer_arena_scope scope{ctx.arena};
         return op.compute(output_shape, args);
     }
     value to_value() const
@@ -243,8 +253,10 @@ struct ref_pad
 
     std::string name() const { return "ref::pad"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
+    argument compute(context& ctx, const dyn_output& dyn_out, std::vector<argument> args) const
     {
+        // Every element of the result is written
+        buffer_arena_scope scope{ctx.arena, false};
         assert(dyn_out.computed_shape.standard());
         argument result{dyn_out.computed_shape};
         result.visit([&](auto output) {
@@ -280,8 +292,9 @@ struct ref_gemm
     std::string name() const { return "ref::dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
 
-    argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
+    argument compute(context& ctx, const dyn_output& dyn_out, std::vector<argument> args) const
     {
+        buffer_arena_scope scope{ctx.arena};
         argument result{dyn_out.computed_shape};
         migemm(result, args[0], args[1], 1.0f, 0.0f);
 
@@ -303,10 +316,19 @@ struct ref_quant_gemm
     std::string name() const { return "ref::quant_dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
 
-    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
     {
+        buffer_arena_scope scope{ctx.arena};
         argument result{output_shape};
-        // first, convert the args[0] and args[1] from int8_t to int32_t
+        // int8 inputs are accumulated directly into the int32 result by migemm
+        if(args.at(0).get_shape().type() == shape::int8_type and
+           args.at(1).get_shape().type() == shape::int8_type and
+           output_shape.type() == shape::int32_type)
+        {
+            migemm(result, args.at(0), args.at(1), int32_t{1}, int32_t{0});
+            return result;
+        }
+        // otherwise, convert the args[0] and args[1] to int32_t
         argument arg_0{{shape::int32_type, {args.at(0).get_shape().lens()}}};
         argument arg_1{{shape::int32_type, {args.at(1).get_shape().lens()}}};
         arg_0.visit([&](auto output) {
@@ -346,8 +368,10 @@ struct ref_softmax : auto_register_op<ref_softmax<Op>>
     {
         return op.normalize_compute_shape(inputs);
     }
-    argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
+    argument compute(context& ctx, const dyn_output& dyn_out, std::vector<argument> args) const
     {
+        // Every element of the result is written
+        buffer_arena_scope scope{ctx.arena, false};
         argument result{dyn_out.computed_shape};
         auto batch_lens        = dyn_out.computed_shape.lens();
         int64_t tuned_axis     = tune_axis(args[0].get_shape().lens().size(), op.axis, op.name());
@@ -442,6 +466,64 @@ struct ref_rnn_var_sl_last_output
 };
 MIGRAPHX_REGISTER_OP(ref_rnn_var_sl_last_output)
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_HOST_JIT)
+
+// Evaluates a pointwise module with the kernel compiled for the host when it was lowered, or
+// interprets the module when it could not be compiled
+struct ref_pointwise
+{
+    op::pointwise op;
+    // Not saved with the program, finalize compiles it again for a loaded program
+    host_pointwise_kernel kernel = nullptr;
+
+    // Smaller modules are cheaper to interpret than to call a kernel for
+    static bool use_kernel(const shape& output)
+    {
+        return not output.dynamic() and output.elements() >= 1024;
+    }
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "ref::pointwise"; }
+    shape compute_shape(const std::vector<shape>& inputs, std::vector<module_ref> mods) const
+    {
+        return op.compute_shape(inputs, std::move(mods));
+    }
+
+    void finalize(context&,
+                  const shape& output,
+                  const std::vector<shape>& inputs,
+                  const std::vector<module_ref>& mods)
+    {
+        if(kernel == nullptr and use_kernel(output))
+            kernel = compile_host_pointwise(*mods.front(), output, inputs);
+    }
+
+    argument compute(context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const std::function<std::vector<argument>(
+                         module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
+    {
+        if(not kernel)
+        {
+            buffer_arena_scope scope{ctx.arena};
+            return op.compute(output_shape, args, mods, run);
+        }
+        // Every element of the result is written
+        buffer_arena_scope scope{ctx.arena, false};
+        argument result{output_shape};
+        kernel(result, args);
+        return result;
+    }
+};
+MIGRAPHX_REGISTER_OP(ref_pointwise)
+
 struct ref_apply
 {
     module* mod;
@@ -470,6 +552,8 @@ struct ref_apply
         apply_map["softmax"]    = extend_op<ref_softmax<op::softmax>, op::softmax>();
         apply_map["rnn_var_sl_last_output"] =
             extend_op<ref_rnn_var_sl_last_output, op::rnn_var_sl_last_output>();
+        if(enabled(MIGRAPHX_ENABLE_HOST_JIT{}))
+            apply_map["pointwise"] = [this](instruction_ref ins) { apply_pointwise(ins); };
     }
 
     void apply()
@@ -493,6 +577,17 @@ struct ref_apply
         mod->replace_instruction(ins, ref_op{ins->get_operator()}, ins->inputs());
     }
 
+    // Large pointwise modules are compiled for the host here, so evaluating them only calls the
+    // kernel
+    void apply_pointwise(instruction_ref ins) const
+    {
+        ref_pointwise op{any_cast<op::pointwise>(ins->get_operator())};
+        if(ref_pointwise::use_kernel(ins->get_shape()))
+            op.kernel = compile_host_pointwise(
+                *ins->module_inputs().front(), ins->get_shape(), to_shapes(ins->inputs()));
+        mod->replace_instruction(ins, op, ins->inputs(), ins->module_inputs());
+    }
+
     template <class T>
     void apply_simple_op(instruction_ref ins)
     {
@@ -507,7 +602,23 @@ struct ref_apply
     }
 };
 
-void lowering::apply(module& m) const { ref_apply{&m}.apply(); }
+// Pointwise submodules keep their original operators, so they can be compiled for the host
+static bool is_pointwise_module(const module* parent, const module& m)
+{
+    if(parent == nullptr)
+        return false;
+    return std::any_of(parent->begin(), parent->end(), [&](const instruction& ins) {
+        return ins.name() == "pointwise" and contains(ins.module_inputs(), &m);
+    });
+}
+
+void lowering::apply(module_pass_manager& mpm) const
+{
+    auto& m = mpm.get_module();
+    if(is_pointwise_module(mpm.get_common_parent(), m))
+        return;
+    ref_apply{&m}.apply();
+}
 
 } // namespace ref
 } // namespace MIGRAPHX_INLINE_NS
@@ -33,26 +33,37 @@
 #include <migraphx/dead_code_elimination.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/split_single_dyn_dim.hpp>
+#include <migraphx/env.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace ref {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_RNN_SEQUENCE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_DYN_DIM_BUCKETS)
+
 std::string target::name() const { return "ref"; }
 
 std::vector<pass> target::get_passes(migraphx::context&, const compile_options&) const
 {
-    return {normalize_ops{},
-            eliminate_pad{},
-            dead_code_elimination{},
-            insert_pad{},
-            dead_code_elimination{},
-            rewrite_rnn{},
-            dead_code_elimination{},
-            auto_contiguous{},
-            dead_code_elimination{},
-            lowering{},
-            dead_code_elimination{}};
+    std::vector<pass> passes;
+    // Run a single dynamic dimension as padded static buckets
+    if(enabled(MIGRAPHX_ENABLE_DYN_DIM_BUCKETS{}))
+        passes = {split_single_dyn_dim{true}, dead_code_elimination{}};
+    passes.insert(passes.end(),
+                  {normalize_ops{},
+                   eliminate_pad{},
+                   dead_code_elimination{},
+                   insert_pad{},
+                   dead_code_elimination{},
+                   rewrite_rnn{enabled(MIGRAPHX_ENABLE_RNN_SEQUENCE{})},
+                   dead_code_elimination{},
+                   auto_contiguous{},
+                   dead_code_elimination{},
+                   lowering{},
+                   dead_code_elimination{}});
+    return passes;
 }
 
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
@@ -0,0 +1,272 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_THREAD_AFFINITY)
+
+struct task_queue
+{
+    std::mutex m;
+    std::deque<std::function<void()>> tasks;
+};
+
+struct thread_pool::impl
+{
+    std::vector<task_queue> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next_queue{0};
+    bool stop = false;
+
+    std::atomic<std::size_t> regions{0};
+    std::atomic<std::size_t> chunks{0};
+    std::atomic<std::size_t> tasks{0};
+    std::atomic<std::size_t> steals{0};
+
+    explicit impl(std::size_t n) : queues(n) {}
+
+    bool pop(std::size_t i, std::function<void()>& task)
+    {
+        std::lock_guard<std::mutex> lock(queues[i].m);
+        if(queues[i].tasks.empty())
+            return false;
+        task = std::move(queues[i].tasks.front());
+        queues[i].tasks.pop_front();
+        pending--;
+        return true;
+    }
+
+    bool steal(std::size_t i, std::function<void()>& task)
+    {
+        for(std::size_t k = 1; k < queues.size(); k++)
+        {
+            auto j = (i + k) % queues.size();
+            std::lock_guard<std::mutex> lock(queues[j].m);
+            if(queues[j].tasks.empty())
+                continue;
+            task = std::move(queues[j].tasks.back());
+            queues[j].tasks.pop_back();
+            pending--;
+            steals++;
+            return true;
+        }
+        return false;
+    }
+
+    void push(std::function<void()> task)
+    {
+        auto i = next_queue++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[i].m);
+            queues[i].tasks.push_back(std::move(task));
+            pending++;
+        }
+        // Taking the lock ensures a worker checking pending cant miss the notification
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        sleep_cv.notify_one();
+    }
+
+    void run(std::size_t i)
+    {
+        for(;;)
+        {
+            std::function<void()> task;
+            if(pop(i, task) or steal(i, task))
+            {
+                // Counted before running since the task may let its caller return
+                tasks++;
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [&] { return stop or pending > 0; });
+            if(stop and pending == 0)
+                return;
+        }
+    }
+};
+
+static void pin_thread(std::thread& t, std::size_t i)
+{
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(i % std::max(1u, std::thread::hardware_concurrency()), &cpuset);
+    pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+    (void)t;
+    (void)i;
+#endif
+}
+
+thread_pool::thread_pool(std::size_t n, bool pin)
+    : pimpl(std::make_unique<impl>(std::max<std::size_t>(n, 1)))
+{
+    auto nworkers = pimpl->queues.size();
+    pimpl->workers.reserve(nworkers);
+    for(std::size_t i = 0; i < nworkers; i++)
+    {
+        pimpl->workers.emplace_back([this, i] { pimpl->run(i); });
+        if(pin)
+            pin_thread(pimpl->workers.back(), i);
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(pimpl->sleep_mutex);
+        pimpl->stop = true;
+    }
+    pimpl->sleep_cv.notify_all();
+    for(auto& t : pimpl->workers)
+        t.join();
+}
+
+std::size_t thread_pool::size() const { return pimpl->workers.size(); }
+
+void thread_pool::submit(std::function<void()> task) { pimpl->push(std::move(task)); }
+
+struct parallel_region
+{
+    std::size_t n;
+    std::size_t grainsize;
+    const std::function<void(std::size_t, std::size_t, std::size_t)>* f = nullptr;
+    std::atomic<std::size_t>* chunks                                     = nullptr;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> next_tid{0};
+    std::size_t finished = 0;
+    std::exception_ptr error;
+    std::mutex m;
+    std::condition_variable cv;
+
+    void work(std::size_t tid)
+    {
+        for(;;)
+        {
+            auto start = next.fetch_add(grainsize);
+            if(start >= n)
+                break;
+            auto last = std::min(n, start + grainsize);
+            std::exception_ptr e;
+            try
+            {
+                (*f)(start, last, tid);
+            }
+            catch(...)
+            {
+                e = std::current_exception();
+            }
+            // Counted before the chunk is marked finished, which lets the caller return
+            (*chunks)++;
+            std::lock_guard<std::mutex> lock(m);
+            if(e and not error)
+                error = e;
+            finished += last - start;
+            if(finished == n)
+                cv.notify_all();
+        }
+    }
+};
+
+void thread_pool::parallel_for(std::size_t n,
+                               std::size_t nthreads,
+                               std::size_t grainsize,
+                               const std::function<void(std::size_t, std::size_t, std::size_t)>& f)
+{
+    if(n == 0)
+        return;
+    auto region       = std::make_shared<parallel_region>();
+    region->n         = n;
+    region->grainsize = std::max<std::size_t>(grainsize, 1);
+    region->f         = &f;
+    region->chunks    = &pimpl->chunks;
+    pimpl->regions++;
+    nthreads = std::min(nthreads, (n + region->grainsize - 1) / region->grainsize);
+    // The calling thread takes tid 0, so only nthreads - 1 helpers are needed
+    region->next_tid = 1;
+    for(std::size_t i = 1; i < nthreads; i++)
+    {
+        pimpl->push([region, this] {
+            // Helpers that start after all the work is claimed never touch f
+            if(region->next >= region->n)
+                return;
+            region->work(region->next_tid++);
+        });
+    }
+    region->work(0);
+    std::unique_lock<std::mutex> lock(region->m);
+    region->cv.wait(lock, [&] { return region->finished == region->n; });
+    if(region->error)
+        std::rethrow_exception(region->error);
+}
+
+thread_pool_stats thread_pool::get_stats() const
+{
+    thread_pool_stats stats;
+    stats.regions = pimpl->regions;
+    stats.chunks  = pimpl->chunks;
+    stats.tasks   = pimpl->tasks;
+    stats.steals  = pimpl->steals;
+    return stats;
+}
+
+void thread_pool::reset_stats()
+{
+    pimpl->regions = 0;
+    pimpl->chunks  = 0;
+    pimpl->tasks   = 0;
+    pimpl->steals  = 0;
+}
+
+thread_pool& get_thread_pool()
+{
+    static thread_pool pool{value_of(MIGRAPHX_NUM_THREADS{}, std::thread::hardware_concurrency()),
+                            enabled(MIGRAPHX_THREAD_AFFINITY{})};
+    return pool;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
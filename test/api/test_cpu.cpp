@@ -21,6 +21,8 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <algorithm>
+#include <numeric>
 #include <migraphx/migraphx.h>
 #include <migraphx/migraphx.hpp>
 #include "test.hpp"
@@ -64,6 +66,44 @@ TEST_CASE(load_and_run_init_list)
     CHECK(bool{shapes_before.front() == outputs.front().get_shape()});
 }
 
+TEST_CASE(batch_queue_run)
+{
+    auto p = migraphx::parse_onnx("sum_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::batch_queue_options options;
+    options.set_timeout(100000);
+    migraphx::batch_queue q{p, options};
+    CHECK(q.max_batch() == 3);
+    auto param_shapes = p.get_parameter_shapes();
+    // The requests fill two batches of 3 and the last one is padded, so the
+    // outputs have to be split back to each request
+    std::vector<size_t> samples = {1, 2, 2, 1, 1};
+    std::vector<std::vector<float>> inputs;
+    std::vector<migraphx::batch_result> results;
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        inputs.emplace_back(samples[i]);
+        std::iota(inputs.back().begin(), inputs.back().end(), 10.0f * i);
+        migraphx::shape s(migraphx_shape_float_type, {samples[i]});
+        migraphx::program_parameters pp;
+        for(auto&& name : param_shapes.names())
+            pp.add(name, migraphx::argument(s, inputs.back().data()));
+        results.push_back(q.submit(pp));
+    }
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        auto outputs = results[i].get();
+        CHECK(results[i].ready());
+        CHECK(outputs.size() == 1);
+        CHECK(outputs.front().get_shape().lengths() == std::vector<size_t>{samples[i]});
+        std::vector<float> expected(samples[i]);
+        std::transform(inputs[i].begin(), inputs[i].end(), expected.begin(), [](auto x) {
+            return 3 * x;
+        });
+        CHECK(outputs.front().as_vector<float>() == expected);
+    }
+}
+
 TEST_CASE(quantize_fp16)
 {
     auto p1        = migraphx::parse_onnx("gemm_test.onnx");
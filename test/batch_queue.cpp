@@ -0,0 +1,120 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/batch_queue.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <numeric>
+#include <test.hpp>
+
+static migraphx::program make_add_program(const migraphx::shape& s)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), x, y)});
+    p.compile(migraphx::make_target("ref"));
+    return p;
+}
+
+static migraphx::parameter_map make_request(std::size_t samples, float value)
+{
+    migraphx::shape s{migraphx::shape::float_type, {samples, 3}};
+    std::vector<float> x(s.elements());
+    std::iota(x.begin(), x.end(), value);
+    std::vector<float> y(s.elements(), value);
+    return {{"x", migraphx::argument{s, x.data()}.copy()},
+            {"y", migraphx::argument{s, y.data()}.copy()}};
+}
+
+static std::vector<float> expected(std::size_t samples, float value)
+{
+    std::vector<float> result(samples * 3);
+    std::iota(result.begin(), result.end(), 2 * value);
+    return result;
+}
+
+static std::vector<float> to_vector(const migraphx::argument& arg)
+{
+    std::vector<float> result;
+    arg.visit([&](auto v) { result.assign(v.begin(), v.end()); });
+    return result;
+}
+
+TEST_CASE(batch_queue_static)
+{
+    migraphx::batch_queue q{make_add_program({migraphx::shape::float_type, {4, 3}}),
+                            {0, std::chrono::milliseconds{100}}};
+    EXPECT(q.max_batch() == 4);
+    std::vector<migraphx::batch_result> results;
+    std::vector<std::size_t> samples = {1, 2, 1, 3};
+    for(std::size_t i = 0; i < samples.size(); i++)
+        results.push_back(q.submit(make_request(samples[i], 10.0f * i)));
+    for(std::size_t i = 0; i < samples.size(); i++)
+    {
+        const auto& out = results[i].get();
+        EXPECT(out.size() == 1);
+        EXPECT(out.front().get_shape().lens() == std::vector<std::size_t>{samples[i], 3});
+        EXPECT(to_vector(out.front()) == expected(samples[i], 10.0f * i));
+    }
+}
+
+TEST_CASE(batch_queue_dynamic)
+{
+    migraphx::shape s{migraphx::shape::float_type, {{1, 8}, {3, 3}}};
+    migraphx::batch_queue q{make_add_program(s), {3, std::chrono::milliseconds{100}}};
+    EXPECT(q.max_batch() == 3);
+    std::vector<migraphx::batch_result> results;
+    for(std::size_t i = 0; i < 7; i++)
+        results.push_back(q.submit(make_request(1, i)));
+    for(std::size_t i = 0; i < 7; i++)
+        EXPECT(to_vector(results[i].get().front()) == expected(1, i));
+}
+
+TEST_CASE(batch_queue_shared)
+{
+    migraphx::batch_result result;
+    {
+        migraphx::batch_queue q{make_add_program({migraphx::shape::float_type, {2, 3}})};
+        auto copy = q;
+        result    = copy.submit(make_request(1, 5));
+    }
+    // Destroying the queue still finishes the queued requests
+    EXPECT(to_vector(result.get().front()) == expected(1, 5));
+}
+
+TEST_CASE(batch_queue_bad_request)
+{
+    migraphx::batch_queue q{make_add_program({migraphx::shape::float_type, {2, 3}})};
+    EXPECT(test::throws([&] { q.submit(make_request(3, 0)); }));
+    EXPECT(test::throws([&] { q.submit({{"x", make_request(1, 0).at("x")}}); }));
+    migraphx::shape s{migraphx::shape::float_type, {1, 4}};
+    EXPECT(test::throws([&] {
+        q.submit({{"x", migraphx::generate_argument(s)}, {"y", migraphx::generate_argument(s)}});
+    }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,167 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/buffer_arena.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/ref/context.hpp>
+#include <algorithm>
+#include "test.hpp"
+
+TEST_CASE(arena_reuse)
+{
+    migraphx::buffer_arena arena;
+    char* first = nullptr;
+    {
+        auto buffer = arena.allocate(64);
+        first       = buffer.get();
+        std::fill(buffer.get(), buffer.get() + 64, 1);
+    }
+    auto buffer = arena.allocate(64);
+    EXPECT(buffer.get() == first);
+    EXPECT(std::all_of(buffer.get(), buffer.get() + 64, [](char c) { return c == 0; }));
+    auto other = arena.allocate(64);
+    EXPECT(other.get() != first);
+    auto stats = arena.get_stats();
+    EXPECT(stats.allocations == 3);
+    EXPECT(stats.heap_allocations == 2);
+    EXPECT(stats.reserved_bytes == 128);
+}
+
+TEST_CASE(arena_release)
+{
+    migraphx::buffer_arena arena;
+    auto used = arena.allocate(64);
+    arena.allocate(128);
+    arena.release();
+    EXPECT(arena.get_stats().reserved_bytes == 64);
+}
+
+TEST_CASE(arena_outlives_owner)
+{
+    std::shared_ptr<char> buffer;
+    {
+        migraphx::buffer_arena arena;
+        buffer = arena.allocate(8);
+    }
+    buffer.get()[7] = 1;
+    EXPECT(buffer.get()[0] == 0);
+}
+
+TEST_CASE(arena_size_class)
+{
+    migraphx::buffer_arena arena;
+    char* first = nullptr;
+    {
+        auto buffer = arena.allocate(1000);
+        first       = buffer.get();
+    }
+    // Sizes in the same class share buffers
+    auto buffer = arena.allocate(1010);
+    EXPECT(buffer.get() == first);
+    EXPECT(arena.get_stats().heap_allocations == 1);
+    EXPECT(arena.get_stats().reserved_bytes >= 1010);
+    EXPECT(arena.get_stats().reserved_bytes < 1250);
+}
+
+TEST_CASE(arena_max_free_bytes)
+{
+    migraphx::buffer_arena arena{128};
+    {
+        auto a = arena.allocate(128);
+        auto b = arena.allocate(128);
+        EXPECT(arena.get_stats().reserved_bytes == 256);
+    }
+    // Only one of the buffers is kept
+    auto stats = arena.get_stats();
+    EXPECT(stats.free_bytes == 128);
+    EXPECT(stats.reserved_bytes == 128);
+}
+
+TEST_CASE(arena_no_zero)
+{
+    migraphx::buffer_arena arena;
+    {
+        auto buffer = arena.allocate(64, false);
+        std::fill(buffer.get(), buffer.get() + 64, 1);
+    }
+    auto buffer = arena.allocate(64);
+    EXPECT(std::all_of(buffer.get(), buffer.get() + 64, [](char c) { return c == 0; }));
+}
+
+TEST_CASE(arena_release_on_destroy)
+{
+    std::shared_ptr<char> buffer;
+    {
+        migraphx::buffer_arena arena;
+        auto copy = arena;
+        arena.allocate(8);
+        buffer = arena.allocate(8);
+    }
+    // The buffer still in use is returned to an arena that no longer keeps it
+    buffer.get()[7] = 1;
+    buffer.reset();
+}
+
+TEST_CASE(arena_scope)
+{
+    migraphx::buffer_arena arena;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    {
+        migraphx::buffer_arena_scope scope{arena};
+        migraphx::argument a{s};
+        migraphx::argument b{s};
+    }
+    migraphx::argument c{s};
+    EXPECT(arena.get_stats().allocations == 2);
+}
+
+TEST_CASE(ref_eval_reuses_buffers)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {8, 8}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, y);
+    mm->add_instruction(migraphx::make_op("dot"), mul, add);
+    p.compile(migraphx::make_target("ref"));
+    migraphx::parameter_map params;
+    params["x"] = migraphx::generate_argument(s, 0);
+    params["y"] = migraphx::generate_argument(s, 1);
+
+    auto& ctx  = *p.get_context().any_cast<migraphx::ref::context>();
+    auto first = p.eval(params).back();
+    auto heap  = ctx.arena.get_stats().heap_allocations;
+    EXPECT(heap > 0);
+    auto second = p.eval(params).back();
+    EXPECT(first == second);
+    // Only the result that is still held from the first run needs a new buffer
+    EXPECT(ctx.arena.get_stats().heap_allocations == heap + 1);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/calibration.hpp>
+#include <migraphx/quantization.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "test.hpp"
+
+static migraphx::argument make_arg(std::vector<float> data)
+{
+    migraphx::shape s{migraphx::shape::float_type, {data.size()}};
+    return migraphx::literal{s, data}.get_argument();
+}
+
+TEST_CASE(histogram_max_abs)
+{
+    migraphx::calibration_histogram h{64};
+    h.add(make_arg({0.5f, -3.0f, 1.0f, 2.0f}));
+    EXPECT(h.total() == 4);
+    EXPECT(h.max_abs == 3.0f);
+    EXPECT(h.range == 4.0f);
+    migraphx::calibration_options options;
+    auto params = h.quant_params(options);
+    EXPECT(params.first == 127.0f / 3.0f);
+    EXPECT(params.second == 0.0f);
+}
+
+TEST_CASE(histogram_grow)
+{
+    migraphx::calibration_histogram h{8};
+    h.add(make_arg({0.1f, 0.6f, 0.9f}));
+    EXPECT(h.range == 1.0f);
+    EXPECT(h.counts[0] == 1 and h.counts[4] == 1 and h.counts[7] == 1);
+    h.add(make_arg({3.5f}));
+    EXPECT(h.range == 4.0f);
+    EXPECT(h.total() == 4);
+    EXPECT(h.counts[0] == 1 and h.counts[1] == 2 and h.counts[7] == 1);
+    EXPECT(h.max_abs == 3.5f);
+}
+
+TEST_CASE(histogram_parallel_chunks)
+{
+    std::vector<float> data(100000);
+    std::iota(data.begin(), data.end(), 0.0f);
+    migraphx::calibration_histogram h{2048};
+    h.add(make_arg(data));
+    EXPECT(h.total() == data.size());
+    EXPECT(h.max_abs == 99999.0f);
+    EXPECT(h.range == 131072.0f);
+}
+
+TEST_CASE(histogram_zeros)
+{
+    migraphx::calibration_histogram h{16};
+    migraphx::calibration_options options;
+    EXPECT(h.quant_params(options).first == 64.0f);
+    h.add(make_arg({0.0f, 0.0f}));
+    EXPECT(h.quant_params(options).first == 1.0f);
+}
+
+TEST_CASE(histogram_outliers)
+{
+    // Merging the two common values into one level loses more than clipping the outlier
+    std::vector<float> data(10000, 0.25f);
+    std::fill(data.begin() + 8000, data.end(), 1.25f);
+    data.back() = 1000.0f;
+    migraphx::calibration_histogram h{2048};
+    h.add(make_arg(data));
+    migraphx::calibration_options options;
+    EXPECT(h.threshold(options) == 1000.0f);
+    options.method     = migraphx::calibration_method::percentile;
+    options.percentile = 99.9;
+    EXPECT(h.threshold(options) < 2.0f);
+    options.method = migraphx::calibration_method::entropy;
+    EXPECT(h.threshold(options) < 1000.0f);
+}
+
+TEST_CASE(histogram_entropy_bin)
+{
+    migraphx::calibration_histogram h{256};
+    h.range   = 256.0f;
+    h.max_abs = 256.0f;
+    std::fill(h.counts.begin(), h.counts.begin() + 192, 1000);
+    migraphx::calibration_options options;
+    options.method = migraphx::calibration_method::entropy;
+    // The smallest threshold that keeps every value
+    EXPECT(h.threshold(options) == 192.0f);
+    // A few values in the last two bins cost more when merged into one level than when clipped
+    h.counts[254] = 1;
+    h.counts[255] = 3;
+    EXPECT(h.threshold(options) == 192.0f);
+    // Values spread evenly over the whole range are kept
+    std::fill(h.counts.begin(), h.counts.end(), 1000);
+    EXPECT(h.threshold(options) == 256.0f);
+}
+
+TEST_CASE(calibration_save_load)
+{
+    migraphx::tmp_dir td{"calibration"};
+    auto filename = (td.path / "table.json").string();
+    std::vector<std::pair<float, float>> params = {{127.0f / 3.0f, 0.0f}, {64.0f, 0.0f}};
+    migraphx::save_calibration(params, filename);
+    auto loaded = migraphx::load_calibration(filename);
+    EXPECT(loaded.size() == params.size());
+    EXPECT(std::equal(loaded.begin(), loaded.end(), params.begin()));
+}
+
+TEST_CASE(calibrate_then_quantize)
+{
+    auto create_program = [] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape sa{migraphx::shape::float_type, {2, 16}};
+        migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+        auto pa = mm->add_parameter("a", sa);
+        auto pb = mm->add_parameter("b", sb);
+        auto r  = mm->add_instruction(migraphx::make_op("dot"), pa, pb);
+        mm->add_return({r});
+        return p;
+    };
+    migraphx::parameter_map m;
+    m["a"] = migraphx::generate_argument({migraphx::shape::float_type, {2, 16}}, 1);
+    m["b"] = migraphx::generate_argument({migraphx::shape::float_type, {16, 8}}, 2);
+    auto t = migraphx::make_target("ref");
+
+    auto p1 = create_program();
+    migraphx::calibration_options options;
+    options.method = migraphx::calibration_method::percentile;
+    auto params    = migraphx::calibrate_int8(p1, t, {m}, {"dot"}, options);
+    EXPECT(params.size() == 2);
+    migraphx::quantize_int8(p1, params, {"dot"});
+
+    auto p2 = create_program();
+    migraphx::quantize_int8(p2, t, {m}, {"dot"}, options);
+    EXPECT(p1 == p2);
+
+    auto p3 = create_program();
+    EXPECT(test::throws([&] { migraphx::quantize_int8(p3, {params.front()}, {"dot"}); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,187 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include "test.hpp"
+
+static migraphx::program create_program(int value = 2)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto two = mm->add_literal(value);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, two);
+    mm->add_return({add});
+    return p;
+}
+
+static migraphx::value describe(const migraphx::program& p,
+                                const migraphx::target& t,
+                                const migraphx::compile_options& options = {})
+{
+    return migraphx::compile_cache::describe(p, t, t.get_context(), options);
+}
+
+TEST_CASE(key)
+{
+    auto t = migraphx::make_target("ref");
+    auto d = describe(create_program(), t);
+    auto k = migraphx::compile_cache::key(d);
+    EXPECT(k.size() == 16);
+    EXPECT(k == migraphx::compile_cache::key(describe(create_program(), t)));
+    EXPECT(d.at("migraphx_version").to<std::string>() == migraphx::get_migraphx_version());
+    EXPECT(d.contains("context"));
+    // The literal data is part of the key
+    EXPECT(k != migraphx::compile_cache::key(describe(create_program(3), t)));
+    migraphx::compile_options options;
+    options.exhaustive_tune = true;
+    EXPECT(k != migraphx::compile_cache::key(describe(create_program(), t, options)));
+}
+
+TEST_CASE(env_settings)
+{
+    auto t   = migraphx::make_target("ref");
+    auto d   = describe(create_program(), t);
+    auto env = d.at("env");
+    for(const auto* name : {"MIGRAPHX_ENABLE_HOST_JIT",
+                            "MIGRAPHX_DISABLE_SCHEDULE_PASS",
+                            "MIGRAPHX_CPU_STREAMS"})
+    {
+        auto e = migraphx::env(name);
+        EXPECT(env.contains(name) == not e.empty());
+        if(not e.empty())
+            EXPECT(env.at(name).to<std::string>() == e.front());
+    }
+    EXPECT(not env.contains("MIGRAPHX_COMPILE_CACHE_DIR"));
+}
+
+TEST_CASE(changed_setting)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_cache cache{td.path, 0};
+    auto t = migraphx::make_target("ref");
+    auto p = create_program();
+    auto d = describe(p, t);
+    p.compile(t);
+    cache.store(d, p);
+    EXPECT(cache.load(d).has_value());
+    // A program compiled for a different stream count is not reused
+    auto changed = d;
+    changed["env"]["MIGRAPHX_CPU_STREAMS"] =
+        std::to_string(migraphx::value_of("MIGRAPHX_CPU_STREAMS", 1) + 1);
+    EXPECT(migraphx::compile_cache::key(changed) != migraphx::compile_cache::key(d));
+    EXPECT(not cache.load(changed).has_value());
+}
+
+TEST_CASE(store_and_load)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_cache cache{td.path / "cache", 0};
+    auto t  = migraphx::make_target("ref");
+    auto p1 = create_program();
+    auto d  = describe(p1, t);
+    EXPECT(not cache.load(d).has_value());
+
+    p1.compile(t);
+    cache.store(d, p1);
+    EXPECT(migraphx::fs::exists(cache.path(migraphx::compile_cache::key(d))));
+    auto p2 = cache.load(d);
+    EXPECT(p2.has_value());
+    EXPECT(p2->is_compiled());
+    EXPECT(p1.sort() == p2->sort());
+}
+
+TEST_CASE(description_mismatch)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_cache cache{td.path, 0};
+    auto t = migraphx::make_target("ref");
+    auto p = create_program();
+    auto d = describe(p, t);
+    p.compile(t);
+    cache.store(d, p);
+    // Another description that hashes to the same key must not load this entry
+    auto key   = migraphx::compile_cache::key(d);
+    auto other = describe(create_program(3), t);
+    auto text  = migraphx::to_json_string(other);
+    migraphx::write_buffer((td.path / (key + ".json")).string(), text.data(), text.size());
+    EXPECT(not cache.load(d).has_value());
+    EXPECT(migraphx::fs::exists(cache.path(key)));
+}
+
+TEST_CASE(corrupt_entry)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    migraphx::compile_cache cache{td.path, 0};
+    auto t          = migraphx::make_target("ref");
+    auto d          = describe(create_program(), t);
+    std::string key = migraphx::compile_cache::key(d);
+    auto text       = migraphx::to_json_string(d);
+    migraphx::write_buffer((td.path / (key + ".json")).string(), text.data(), text.size());
+    migraphx::write_buffer(cache.path(key).string(), "garbage", 7);
+    EXPECT(not cache.load(d).has_value());
+    EXPECT(not migraphx::fs::exists(cache.path(key)));
+    EXPECT(not migraphx::fs::exists(td.path / (key + ".json")));
+}
+
+TEST_CASE(evict)
+{
+    migraphx::tmp_dir td{"compile_cache"};
+    auto t = migraphx::make_target("ref");
+    migraphx::compile_cache unbounded{td.path, 0};
+    std::vector<std::string> keys;
+    for(int i = 0; i < 3; i++)
+    {
+        auto p = create_program(i);
+        auto d = describe(p, t);
+        keys.push_back(migraphx::compile_cache::key(d));
+        p.compile(t);
+        unbounded.store(d, p);
+    }
+    auto size = migraphx::fs::file_size(unbounded.path(keys.front()));
+    // Make the first entry the most recently used
+    migraphx::fs::last_write_time(unbounded.path(keys[1]),
+                                  migraphx::fs::last_write_time(unbounded.path(keys[0])) -
+                                      std::chrono::hours{1});
+    migraphx::fs::last_write_time(unbounded.path(keys[2]),
+                                  migraphx::fs::last_write_time(unbounded.path(keys[0])) -
+                                      std::chrono::hours{2});
+
+    migraphx::compile_cache bounded{td.path, size + size / 2};
+    bounded.evict();
+    EXPECT(migraphx::fs::exists(bounded.path(keys[0])));
+    EXPECT(not migraphx::fs::exists(bounded.path(keys[1])));
+    EXPECT(not migraphx::fs::exists(bounded.path(keys[2])));
+    EXPECT(not migraphx::fs::exists(td.path / (keys[1] + ".json")));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,181 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/schedule.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/serialize.hpp>
+#include <test.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+// Adds the first two inputs into the last one, so the scheduled op is
+// queued on its stream's worker
+struct add_into
+{
+    bool fail = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.fail, "fail"));
+    }
+
+    std::string name() const { return "add_into"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.back();
+    }
+    migraphx::argument
+    compute(migraphx::context&, const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        if(fail)
+            throw std::runtime_error("add_into failed");
+        migraphx::visit_all(args[2], args[0], args[1])([](auto output, auto x, auto y) {
+            std::transform(x.begin(), x.end(), y.begin(), output.begin(), std::plus<>{});
+        });
+        return args[2];
+    }
+    std::ptrdiff_t output_alias(const std::vector<migraphx::shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+struct schedule_target
+{
+    std::size_t streams = 1;
+    std::string name() const { return "schedule"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        if(streams < 2)
+            return {};
+        return {migraphx::schedule{migraphx::cpu::schedule_model{streams}}};
+    }
+    migraphx::context get_context() const { return migraphx::cpu::context{streams}; }
+};
+
+const migraphx::shape branch_shape{migraphx::shape::float_type, {256}};
+
+// Independent chains of adds on the input which are summed at the end
+migraphx::program make_branches(std::size_t n, std::size_t fail_branch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", branch_shape);
+    auto add = [&](auto a, auto b, bool fail = false) {
+        auto alloc = mm->add_instruction(
+            migraphx::make_op("allocate", {{"shape", migraphx::to_value(branch_shape)}}));
+        return mm->add_instruction(add_into{fail}, a, b, alloc);
+    };
+    std::vector<migraphx::instruction_ref> branches;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto lit = mm->add_literal(migraphx::generate_literal(branch_shape, i));
+        auto y   = add(x, lit);
+        y        = add(y, lit, i == fail_branch);
+        branches.push_back(add(y, lit));
+    }
+    auto sum = branches.front();
+    for(auto it = std::next(branches.begin()); it != branches.end(); ++it)
+        sum = add(sum, *it);
+    mm->add_return({sum});
+    return p;
+}
+
+migraphx::argument run(migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    params["x"] = migraphx::generate_argument(branch_shape, 7);
+    return p.eval(params).back();
+}
+
+std::vector<std::size_t> used_streams(const migraphx::program& p)
+{
+    std::vector<std::size_t> result;
+    for(const auto& ins : *p.get_main_module())
+    {
+        if(ins.name() == "cpu::stream")
+            result.push_back(ins.get_operator().to_value().at("stream").to<std::size_t>());
+    }
+    return result;
+}
+
+TEST_CASE(schedule_branches)
+{
+    auto p1 = make_branches(4, 4);
+    p1.compile(schedule_target{1});
+    auto p2 = make_branches(4, 4);
+    p2.compile(schedule_target{4});
+    auto streams = used_streams(p2);
+    EXPECT(std::any_of(streams.begin(), streams.end(), [](auto s) { return s > 0; }));
+
+    auto gold = run(p1);
+    for(int i = 0; i < 20; i++)
+        EXPECT(run(p2) == gold);
+}
+
+TEST_CASE(schedule_worker_error)
+{
+    // Fail each branch in turn, and check that at least one of them fails on a worker thread
+    bool on_worker = false;
+    for(std::size_t i = 0; i < 4; i++)
+    {
+        auto p = make_branches(4, i);
+        p.compile(schedule_target{4});
+        for(const auto& ins : *p.get_main_module())
+        {
+            if(ins.name() != "cpu::stream")
+                continue;
+            auto v = ins.get_operator().to_value();
+            if(v.at("op").at("operator").at("fail").to<bool>() and
+               v.at("stream").to<std::size_t>() > 0)
+                on_worker = true;
+        }
+        // eval itself throws, without waiting for the streams afterwards
+        EXPECT(test::throws([&] { run(p); }));
+        // The error is not left behind for the next run
+        EXPECT(test::throws([&] { run(p); }));
+        p.finish();
+    }
+    EXPECT(on_worker);
+}
+
+TEST_CASE(context_streams_value)
+{
+    migraphx::context ctx = migraphx::cpu::context{4};
+    auto v                = ctx.to_value();
+    EXPECT(v.at("streams").to<std::size_t>() == 4);
+    // The stream count is part of the value, so it keys compiled programs
+    EXPECT(v != migraphx::context{migraphx::cpu::context{1}}.to_value());
+    migraphx::cpu::context loaded{1};
+    loaded.from_value(v);
+    EXPECT(loaded.get_nstreams() == 4);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/deduplicate_literals.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/make_op.hpp>
+#include <test.hpp>
+
+void run_pass(migraphx::program& p)
+{
+    migraphx::run_passes(p, {migraphx::deduplicate_literals{}, migraphx::dead_code_elimination{}});
+}
+
+static std::vector<migraphx::literal> get_literals(const migraphx::module& m)
+{
+    std::vector<migraphx::literal> result;
+    for(const auto& ins : m)
+    {
+        if(ins.name() == "@literal")
+            result.push_back(ins.get_literal());
+    }
+    return result;
+}
+
+TEST_CASE(same_shape)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    std::vector<float> zeros(s.elements(), 0);
+    migraphx::program p1;
+    {
+        auto* mm = p1.get_main_module();
+        auto x   = mm->add_parameter("x", s);
+        auto l1  = mm->add_literal(migraphx::literal{s, zeros});
+        auto l2  = mm->add_literal(migraphx::literal{s, zeros});
+        auto a1  = mm->add_instruction(migraphx::make_op("add"), x, l1);
+        auto a2  = mm->add_instruction(migraphx::make_op("add"), a1, l2);
+        mm->add_return({a2});
+    }
+    run_pass(p1);
+
+    migraphx::program p2;
+    {
+        auto* mm = p2.get_main_module();
+        auto x   = mm->add_parameter("x", s);
+        auto l   = mm->add_literal(migraphx::literal{s, zeros});
+        auto a1  = mm->add_instruction(migraphx::make_op("add"), x, l);
+        auto a2  = mm->add_instruction(migraphx::make_op("add"), a1, l);
+        mm->add_return({a2});
+    }
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(different_shape)
+{
+    migraphx::shape s1{migraphx::shape::float_type, {6}};
+    migraphx::shape s2{migraphx::shape::int32_type, {2, 3}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto l1  = mm->add_literal(migraphx::literal{s1, std::vector<float>(6, 0)});
+    auto l2  = mm->add_literal(migraphx::literal{s2, std::vector<int>(6, 0)});
+    auto l3  = mm->add_literal(migraphx::literal{s1, std::vector<float>(6, 1)});
+    mm->add_return({l1, l2, l3});
+    auto expected = p;
+    run_pass(p);
+
+    // Literals are added at the start of the module so they are in reverse order
+    auto lits = get_literals(*mm);
+    EXPECT(lits.size() == 3);
+    EXPECT(lits[2].shares_buffer(lits[1]));
+    EXPECT(not lits[2].shares_buffer(lits[0]));
+    EXPECT(not lits[1].shares_buffer(lits[0]));
+    EXPECT(p.sort() == expected.sort());
+}
+
+TEST_CASE(submodules)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    std::vector<float> ones(s.elements(), 1);
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", s);
+    auto l   = mm->add_literal(migraphx::literal{s, ones});
+
+    auto* then_mod = p.create_module("If_0_if");
+    auto l1        = then_mod->add_literal(migraphx::literal{s, ones});
+    then_mod->add_return({then_mod->add_instruction(migraphx::make_op("add"), x, l1)});
+
+    auto* else_mod = p.create_module("If_0_else");
+    auto l2        = else_mod->add_literal(migraphx::literal{s, ones});
+    else_mod->add_return({else_mod->add_instruction(migraphx::make_op("mul"), x, l2)});
+
+    auto cond = mm->add_parameter("cond", migraphx::shape{migraphx::shape::bool_type});
+    auto ret  = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    auto r    = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), ret);
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), r, l)});
+    auto expected = p;
+    run_pass(p);
+
+    auto main_lits = get_literals(*mm);
+    auto then_lits = get_literals(*then_mod);
+    auto else_lits = get_literals(*else_mod);
+    EXPECT(main_lits.size() == 1);
+    EXPECT(then_lits.size() == 1);
+    EXPECT(else_lits.size() == 1);
+    EXPECT(main_lits.front().shares_buffer(then_lits.front()));
+    EXPECT(main_lits.front().shares_buffer(else_lits.front()));
+    EXPECT(p.sort() == expected.sort());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
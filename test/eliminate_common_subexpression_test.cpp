@@ -171,6 +171,78 @@ TEST_CASE(cse_test_literal)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_chain)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto y1 = x;
+        auto y2 = x;
+        for(int i = 0; i < 8; i++)
+        {
+            y1 = m1.add_instruction(migraphx::make_op("add"), y1, x);
+            y2 = m1.add_instruction(migraphx::make_op("add"), y2, x);
+        }
+        auto sum = m1.add_instruction(migraphx::make_op("mul"), y1, y2);
+        m1.add_instruction(pass_op{}, sum);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        auto y = x;
+        for(int i = 0; i < 8; i++)
+            y = m2.add_instruction(migraphx::make_op("add"), y, x);
+        auto sum = m2.add_instruction(migraphx::make_op("mul"), y, y);
+        m2.add_instruction(pass_op{}, sum);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(cse_test_many_literals)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<float> data = {1, 2, 3, 4};
+    migraphx::module m1;
+    {
+        auto x = m1.add_parameter("x", s);
+        for(int i = 0; i < 100; i++)
+        {
+            auto l = m1.add_literal(migraphx::literal{s, data});
+            x      = m1.add_instruction(migraphx::make_op("add"), x, l);
+        }
+        m1.add_instruction(pass_op{}, x);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", s);
+        auto l = m2.add_literal(migraphx::literal{s, data});
+        for(int i = 0; i < 100; i++)
+            x = m2.add_instruction(migraphx::make_op("add"), x, l);
+        m2.add_instruction(pass_op{}, x);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(cse_test_literal_different_data)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    migraphx::module m1;
+    {
+        auto l1  = m1.add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+        auto l2  = m1.add_literal(migraphx::literal{s, {1, 2, 3, 5}});
+        auto sum = m1.add_instruction(migraphx::make_op("add"), l1, l2);
+        m1.add_instruction(pass_op{}, sum);
+    }
+    auto m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test_submodule)
 {
     migraphx::shape si{migraphx::shape::int64_type};
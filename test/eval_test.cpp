@@ -28,7 +28,9 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/make_op.hpp>
+#include <atomic>
 #include <sstream>
+#include <thread>
 #include "test.hpp"
 #include <basic_ops.hpp>
 
@@ -412,6 +414,136 @@ TEST_CASE(target_test)
     EXPECT(result != migraphx::literal{4});
 }
 
+TEST_CASE(target_eval_twice_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto two = mm->add_literal(2);
+    mm->add_instruction(migraphx::make_op("add"), x, two);
+    p.compile(id_target{});
+    auto one   = migraphx::literal{1};
+    auto three = migraphx::literal{3};
+    EXPECT(p.eval({{"x", one.get_argument()}}).back() == migraphx::literal{3});
+    EXPECT(p.eval({{"x", three.get_argument()}}).back() == migraphx::literal{5});
+    EXPECT(test::throws([&] { p.eval({}); }));
+}
+
+TEST_CASE(target_modify_after_compile_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    p.get_main_module()->replace_instruction(sum, minus_op{}, two, one);
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+}
+
+TEST_CASE(target_modify_held_module_after_compile_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    mm->add_instruction(pass_op{}, sum);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    // The size and the last instruction of the module stay the same
+    auto diff = mm->insert_instruction(sum, minus_op{}, two, one);
+    mm->replace_instruction(sum, diff);
+    mm->remove_instruction(sum);
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+    mm->replace_instruction(diff, sum_op{}, two, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{4});
+}
+
+TEST_CASE(target_modify_submodule_after_compile_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape cond_s{migraphx::shape::bool_type};
+    auto cond = mm->add_parameter("cond", cond_s);
+    auto one  = mm->add_literal(1);
+    auto two  = mm->add_literal(2);
+
+    auto* then_mod = p.create_module("If_0_if");
+    auto sum       = then_mod->add_instruction(sum_op{}, one, one);
+    then_mod->add_return({sum});
+
+    auto* else_mod = p.create_module("If_0_else");
+    else_mod->add_return({else_mod->add_instruction(sum_op{}, two, two)});
+
+    auto ret = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), ret);
+    p.compile(id_target{});
+
+    std::vector<char> c = {1};
+    migraphx::parameter_map params{{"cond", migraphx::argument{cond_s, c.data()}}};
+    EXPECT(p.eval(params).back() == migraphx::literal{2});
+    // The submodule now uses another instruction from the main module
+    then_mod->replace_instruction(sum, sum_op{}, one, two);
+    EXPECT(p.eval(params).back() == migraphx::literal{3});
+}
+
+TEST_CASE(target_concurrent_eval_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, x, two);
+    p.compile(id_target{});
+    // Change the module so the first evals need to rebuild the plan at the same time
+    mm->add_instruction(pass_op{}, std::prev(mm->end()));
+    std::vector<std::thread> threads;
+    std::atomic<bool> ok{true};
+    for(int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&, i] {
+            for(int j = 0; j < 100; j++)
+            {
+                migraphx::literal l{i + j};
+                auto result = p.eval({{"x", l.get_argument()}}).back();
+                if(result != migraphx::literal{i + j + 2})
+                    ok = false;
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(ok.load());
+}
+
+TEST_CASE(target_literal_not_copied_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto lit = mm->add_literal(migraphx::literal{migraphx::shape{migraphx::shape::float_type, {64}},
+                                                 std::vector<float>(64, 1.0f)});
+    mm->add_return({lit});
+    p.compile(id_target{});
+    auto result = p.eval({}).back();
+    EXPECT(result.data() == lit->get_literal().data());
+    EXPECT(p.eval({}).back().data() == lit->get_literal().data());
+}
+
+TEST_CASE(target_copy_test)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, one, two);
+    p1.compile(id_target{});
+    migraphx::program p2 = p1;
+    EXPECT(p2.eval({}).back() == migraphx::literal{3});
+    EXPECT(p1.eval({}).back() == migraphx::literal{3});
+}
+
 TEST_CASE(invert_target_test)
 {
     migraphx::program p;
@@ -26,7 +26,13 @@
 #include <migraphx/cpp_generator.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/host_pointwise.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/instruction.hpp>
 #include <test.hpp>
+#include <cmath>
+#include <numeric>
 
 // NOLINTNEXTLINE
 const std::string add_42_src = R"migraphx(
@@ -104,4 +110,46 @@ TEST_CASE(generate_module_with_literals)
     EXPECT(test::within_abs(f(0, 2), std::sqrt(3)));
 }
 
+TEST_CASE(host_pointwise)
+{
+    migraphx::module m("pointwise");
+    auto x    = m.add_parameter("x0", {migraphx::shape::float_type});
+    auto y    = m.add_parameter("x1", {migraphx::shape::float_type});
+    auto z    = m.add_literal(1.f);
+    auto sum  = m.add_instruction(migraphx::make_op("add"), x, y);
+    auto mul  = m.add_instruction(migraphx::make_op("mul"), sum, z);
+    auto sqrt = m.add_instruction(migraphx::make_op("sqrt"), mul);
+    m.add_return({sqrt});
+
+    migraphx::shape out{migraphx::shape::float_type, {2, 3, 4}};
+    // A transposed input and a broadcasted input
+    migraphx::shape xs{migraphx::shape::float_type, {2, 3, 4}, {1, 8, 2}};
+    migraphx::shape ys{migraphx::shape::float_type, {2, 3, 4}, {0, 1, 0}};
+    auto kernel = migraphx::compile_host_pointwise(m, out, {xs, ys});
+    EXPECT(bool{kernel});
+    std::vector<float> xdata(24);
+    std::iota(xdata.begin(), xdata.end(), 0);
+    std::vector<float> ydata = {1, 2, 3};
+    migraphx::argument result{out};
+    kernel(result, {migraphx::argument{xs, xdata.data()}, migraphx::argument{ys, ydata.data()}});
+
+    std::vector<float> gold(24);
+    migraphx::shape_for_each(out, [&](const auto& idx) {
+        auto i  = out.index(idx);
+        gold[i] = std::sqrt(xdata[xs.index(idx)] + ydata[ys.index(idx)]);
+    });
+    std::vector<float> results;
+    result.visit([&](auto output) { results.assign(output.begin(), output.end()); });
+    EXPECT(results == gold);
+}
+
+TEST_CASE(host_pointwise_unsupported)
+{
+    migraphx::module m("pointwise");
+    auto x = m.add_parameter("x0", {migraphx::shape::half_type});
+    m.add_instruction(migraphx::make_op("sqrt"), x);
+    migraphx::shape s{migraphx::shape::half_type, {4}};
+    EXPECT(not migraphx::compile_host_pointwise(m, s, {s}));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -23,6 +23,7 @@
  */
 
 #include <migraphx/literal.hpp>
+#include <migraphx/literal_storage.hpp>
 #include <migraphx/serialize.hpp>
 #include <sstream>
 #include <string>
@@ -183,4 +184,40 @@ TEST_CASE(literal_to_string_float_precision)
     EXPECT(x.to_string() != "127");
 }
 
+TEST_CASE(literal_share)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::literal l1{s, {1, 2, 3, 4, 5, 6}};
+    migraphx::shape s2{migraphx::shape::float_type, {6}};
+    auto l2 = l1.share(s2);
+    EXPECT(l2.get_shape() == s2);
+    EXPECT(l2.data() == l1.data());
+    EXPECT(l1.shares_buffer(l2));
+    EXPECT(not l1.shares_buffer(migraphx::literal{s, {1, 2, 3, 4, 5, 6}}));
+    EXPECT(not migraphx::literal{}.shares_buffer(migraphx::literal{}));
+}
+
+TEST_CASE(literal_storage_insert)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {4}};
+    migraphx::literal_storage storage;
+    auto l1 = storage.insert(migraphx::literal{s, {0, 0, 0, 0}});
+    auto l2 = storage.insert(migraphx::literal{s, {0, 0, 0, 0}});
+    auto l3 = storage.insert(migraphx::literal{s, {0, 0, 0, 1}});
+    // Same bytes with a different type still share the buffer
+    migraphx::shape sf{migraphx::shape::float_type, {4}};
+    auto l4 = storage.insert(migraphx::literal{sf, {0, 0, 0, 0}});
+    EXPECT(l1.shares_buffer(l2));
+    EXPECT(l1.shares_buffer(l4));
+    EXPECT(not l1.shares_buffer(l3));
+    EXPECT(l4.get_shape() == sf);
+    EXPECT(l3 == migraphx::literal{s, {0, 0, 0, 1}});
+    EXPECT(storage.size() == 2);
+    EXPECT(storage.bytes() == 2 * s.bytes());
+    EXPECT(storage.shared_bytes() == 2 * s.bytes());
+    // Inserting a literal that already uses the stored buffer saves nothing
+    storage.insert(l2);
+    EXPECT(storage.shared_bytes() == 2 * s.bytes());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
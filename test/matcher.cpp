@@ -1086,4 +1086,115 @@ TEST_CASE(match_finder)
     match::find_matches(mm, match_find_sum{sum}, match_find_literal{sum});
 }
 
+struct match_fold_sum
+{
+    auto matcher() const
+    {
+        return match::name("sum")(match::arg(0)(match::name("@literal")),
+                                  match::arg(1)(match::name("@literal")));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        auto ins = r.result;
+        auto x   = ins->inputs().front()->get_literal().at<int>();
+        auto y   = ins->inputs().back()->get_literal().at<int>();
+        m.replace_instruction(ins, m.add_literal(x + y));
+    }
+};
+
+TEST_CASE(match_fixpoint)
+{
+    migraphx::module mm;
+    auto one   = mm.add_literal(1);
+    auto two   = mm.add_literal(2);
+    auto three = mm.add_literal(3);
+    auto x     = mm.add_parameter("x", {migraphx::shape::int32_type});
+    auto sum1  = mm.add_instruction(sum_op{}, one, two);
+    auto sum2  = mm.add_instruction(sum_op{}, three, sum1);
+    for(int i = 0; i < 8; i++)
+        x = mm.add_instruction(pass_op{}, x);
+    mm.add_instruction(pass_op{}, sum2, x);
+    auto n  = mm.size();
+    auto fm = match::find_matches_fixpoint(mm, 8, match_fold_sum{});
+    // The last round visits every instruction again to check nothing is left
+    EXPECT(fm.stats.rounds == 3);
+    // The second round only revisits the instructions around the rewrites
+    EXPECT(fm.stats.visited < 2 * n);
+    EXPECT(std::none_of(mm.begin(), mm.end(), [](const auto& ins) { return ins.name() == "sum"; }));
+    auto last = std::prev(mm.end());
+    EXPECT(last->inputs().front()->get_literal().at<int>() == 6);
+}
+
+// Replaces the sum used by a minus with a literal
+struct match_minus_sum
+{
+    auto matcher() const
+    {
+        return match::name("minus")(match::arg(0)(match::name("sum").bind("x")));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.instructions["x"], m.add_literal(1));
+    }
+};
+
+// Looks three instructions up the first input of a sum
+struct match_deep_sum
+{
+    auto matcher() const
+    {
+        auto literal = match::name("@literal");
+        return match::name("sum")(match::arg(0)(
+            match::name("pass")(match::arg(0)(match::name("pass")(match::arg(0)(literal))))));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.result, m.add_literal(7));
+    }
+};
+
+TEST_CASE(match_fixpoint_deep)
+{
+    migraphx::module mm;
+    auto x  = mm.add_parameter("x", {migraphx::shape::int32_type});
+    auto a  = mm.add_instruction(sum_op{}, x, x);
+    auto p1 = mm.add_instruction(pass_op{}, a);
+    auto p2 = mm.add_instruction(pass_op{}, p1);
+    auto s  = mm.add_instruction(sum_op{}, p2, p2);
+    auto q  = mm.add_instruction(pass_op{}, s);
+    q       = mm.add_instruction(pass_op{}, q);
+    // The sum a is only replaced after s was visited, and s is too far from the rewrite to be
+    // revisited with the instructions around it
+    auto d = mm.add_instruction(minus_op{}, a, x);
+    mm.add_instruction(pass_op{}, q, d);
+    match::find_matches_fixpoint(mm, 8, match_minus_sum{}, match_deep_sum{});
+    EXPECT(std::none_of(mm.begin(), mm.end(), [](const auto& ins) { return ins.name() == "sum"; }));
+}
+
+struct match_swap_sum
+{
+    auto matcher() const { return match::name("sum"); }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        auto ins = r.result;
+        m.replace_instruction(ins, sum_op{}, ins->inputs().back(), ins->inputs().front());
+    }
+};
+
+TEST_CASE(match_fixpoint_max_rounds)
+{
+    migraphx::module mm;
+    auto one = mm.add_literal(1);
+    auto two = mm.add_literal(2);
+    auto sum = mm.add_instruction(sum_op{}, one, two);
+    mm.add_instruction(pass_op{}, sum);
+    auto fm = match::find_matches_fixpoint(mm, 3, match_swap_sum{});
+    EXPECT(fm.stats.rounds == 3);
+    EXPECT(bool{sum->inputs().front() == two});
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -3805,4 +3805,65 @@ TEST_CASE(test_tuple)
     CHECK(is_disjoint({a1, a2}));
 }
 
+void run_best_fit_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::memory_coloring{"allocate", true, true}});
+}
+
+TEST_CASE(best_fit_reuse)
+{
+    migraphx::module m;
+
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto a2 = add_alloc(m, {migraphx::shape::float_type, {40}});
+    auto m2 = m.add_instruction(pass_op{}, a2, m1);
+    auto a3 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    m.add_instruction(pass_op{}, a3, m2);
+    run_best_fit_pass(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 192);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2}));
+    CHECK(is_disjoint({a2, a3}));
+}
+
+TEST_CASE(best_fit_gap)
+{
+    migraphx::module m;
+
+    // a1 and a3 are live across a2 and a4, so a4 fits in the gap a2 leaves behind
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {64}});
+    auto a2 = add_alloc(m, {migraphx::shape::float_type, {32}});
+    auto m2 = m.add_instruction(pass_op{}, a2, a1);
+    auto a3 = add_alloc(m, {migraphx::shape::float_type, {64}});
+    auto m3 = m.add_instruction(pass_op{}, a3, m2);
+    auto a4 = add_alloc(m, {migraphx::shape::float_type, {16}});
+    auto m4 = m.add_instruction(pass_op{}, a4, m3);
+    m.add_instruction(pass_op{}, m4, a1);
+    run_best_fit_pass(m);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2, a3}));
+    CHECK(is_disjoint({a1, a3, a4}));
+    CHECK(m.get_parameter_shape("scratch").bytes() == 640);
+}
+
+TEST_CASE(best_fit_tuple)
+{
+    migraphx::module m;
+
+    auto s1 = migraphx::shape{migraphx::shape::float_type, {8}};
+    auto s2 = migraphx::shape{migraphx::shape::half_type, {10}};
+
+    auto s = migraphx::shape{{s1, s2}};
+
+    auto a1 = add_alloc(m, s);
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto a2 = add_alloc(m, {migraphx::shape::float_type, {4}});
+    m.add_instruction(pass_op{}, a2, m1);
+    run_best_fit_pass(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 68);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2}));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -434,6 +434,20 @@ TEST_CASE(module_without_bypass)
     EXPECT(found);
 }
 
+struct module_local_pass
+{
+    std::string name() const { return "module_local_pass"; }
+    void apply(migraphx::module&) const {}
+    bool is_module_local() const { return true; }
+};
+
+TEST_CASE(pass_module_local)
+{
+    EXPECT(migraphx::pass{module_local_pass{}}.is_module_local());
+    bool found = false;
+    EXPECT(not migraphx::pass{check_for_pass_op{&found}}.is_module_local());
+}
+
 TEST_CASE(multiple_module_dependency)
 {
     // Test when an instruction from a submodule depends on previous module
@@ -25,6 +25,7 @@
 #include <migraphx/value.hpp>
 #include <msgpack.hpp>
 #include <map>
+#include <numeric>
 #include "test.hpp"
 
 template <class T>
@@ -147,4 +148,78 @@ TEST_CASE(test_msgpack_array_class)
     EXPECT(migraphx::from_msgpack(buffer) == v);
 }
 
+TEST_CASE(test_msgpack_aligned_binary)
+{
+    migraphx::value::binary data(std::size_t{100});
+    std::iota(data.begin(), data.end(), 0);
+    migraphx::value v = {{"a", 1.0}, {"data", data}, {"b", {{"c", "abc"}, {"data", data}}}};
+    auto buffer       = migraphx::to_msgpack(v, 64);
+    EXPECT(migraphx::from_msgpack(buffer) == v);
+    // Each payload is aligned and the padding entries are dropped when reading
+    auto mp = migraphx::from_msgpack_view(buffer.data(), buffer.size(), 64);
+    EXPECT(mp.size() == 3);
+    EXPECT(mp.at("a").to<double>() == 1.0);
+    for(const auto& r : {mp.at("data"), mp.at("b").at("data")})
+    {
+        auto offset = r.at("@offset").to<std::size_t>();
+        EXPECT(offset % 64 == 0);
+        EXPECT(r.at("@size").to<std::size_t>() == data.size());
+        EXPECT(std::equal(data.begin(), data.end(), buffer.begin() + offset));
+    }
+}
+
+TEST_CASE(test_msgpack_view_small_binary)
+{
+    migraphx::value::binary data(std::size_t{8});
+    migraphx::value v = {{"data", data}};
+    auto buffer       = migraphx::to_msgpack(v, 64);
+    EXPECT(buffer == migraphx::to_msgpack(v));
+    EXPECT(migraphx::from_msgpack_view(buffer.data(), buffer.size(), 64) == v);
+}
+
+TEST_CASE(test_msgpack_aligned_mid_size_binary)
+{
+    // Binaries smaller than the alignment are still aligned to msgpack_min_alignment
+    migraphx::value::binary data(std::size_t{100});
+    migraphx::value v = {{"a", 1.0}, {"data", data}};
+    auto buffer       = migraphx::to_msgpack(v, 4096);
+    EXPECT(migraphx::from_msgpack(buffer) == v);
+    auto mp = migraphx::from_msgpack_view(buffer.data(), buffer.size(), 64);
+    EXPECT(mp.at("data").at("@offset").to<std::size_t>() % migraphx::msgpack_min_alignment == 0);
+}
+
+TEST_CASE(test_msgpack_binary_ref)
+{
+    std::vector<char> data(5000, 'x');
+    migraphx::value v = {{"a", "abc"}, {"literal", {{"data", {{"@binary", 0}}}}}};
+    std::vector<char> buffer;
+    migraphx::to_msgpack(
+        v,
+        [&](const char* b, std::size_t n) { buffer.insert(buffer.end(), b, b + n); },
+        4096,
+        {{data.data(), data.size()}});
+    migraphx::value expected = {{"a", "abc"},
+                                {"literal", {{"data", migraphx::value::binary{data}}}}};
+    EXPECT(buffer == migraphx::to_msgpack(expected, 4096));
+    EXPECT(migraphx::from_msgpack(buffer) == expected);
+}
+
+TEST_CASE(test_msgpack_binary_ref_user_value)
+{
+    // Only the data of a literal can refer to a binary
+    std::vector<char> data(5000, 'x');
+    migraphx::value v = {{"data", {{"@binary", 0}}}, {"literal", {{"data", {{"@binary", 0}}}}}};
+    std::vector<char> buffer;
+    migraphx::to_msgpack(
+        v,
+        [&](const char* b, std::size_t n) { buffer.insert(buffer.end(), b, b + n); },
+        4096,
+        {{data.data(), data.size()}});
+    migraphx::value expected = {{"data", {{"@binary", 0}}},
+                                {"literal", {{"data", migraphx::value::binary{data}}}}};
+    EXPECT(migraphx::from_msgpack(buffer) == expected);
+    // Without refs the value is written unchanged
+    EXPECT(migraphx::from_msgpack(migraphx::to_msgpack(v, 4096)) == v);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
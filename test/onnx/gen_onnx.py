@@ -1983,6 +1983,56 @@ def external_constant_test():
     return ([node], [], [y])
 
 
+def external_data_file_test(name, tensors):
+    # Initializers that read their data from the given locations, offsets and
+    # lengths, and are returned as the outputs of the graph
+    initializers = []
+    outputs = []
+    for tensor_name, dims, location, offset, length in tensors:
+        tensor = TensorProto()
+        tensor.name = tensor_name
+        tensor.data_type = TensorProto.FLOAT
+        tensor.dims.extend(dims)
+        entries = [('location', location), ('offset', str(offset))]
+        if length is not None:
+            entries.append(('length', str(length)))
+        for key, value in entries:
+            entry = tensor.external_data.add()
+            entry.key = key
+            entry.value = value
+        tensor.data_location = TensorProto.EXTERNAL
+        initializers.append(tensor)
+        outputs.append(
+            helper.make_tensor_value_info(tensor_name, TensorProto.FLOAT,
+                                          dims))
+    graph_def = helper.make_graph([], name, [], outputs, initializer=initializers)
+    model_def = helper.make_model(graph_def, producer_name=name)
+    onnx.save_model(model_def, '{}.onnx'.format(name))
+
+
+def external_data_layout_test():
+    # a and b are aligned and share the file, c starts at an unaligned offset
+    np.arange(32, dtype=np.float32).tofile('external_data_layout_test.weight')
+    external_data_file_test(
+        'external_data_layout_test',
+        [('a', [4], 'external_data_layout_test.weight', 0, 16),
+         ('b', [4], 'external_data_layout_test.weight', 64, 16),
+         ('c', [3], 'external_data_layout_test.weight', 20, 12)])
+
+
+def external_data_truncated_test():
+    np.arange(2, dtype=np.float32).tofile('external_data_truncated_test.weight')
+    external_data_file_test(
+        'external_data_truncated_test',
+        [('x', [4], 'external_data_truncated_test.weight', 0, None)])
+
+
+def external_data_offset_test():
+    external_data_file_test(
+        'external_data_offset_test',
+        [('x', [4], 'external_data_layout_test.weight', 4096, 16)])
+
+
 @onnx_test()
 def eyelike_default_test():
     T1 = helper.make_tensor_value_info('T1', TensorProto.FLOAT, [3, 4])
@@ -1988,6 +1988,36 @@ TEST_CASE(external_data_diff_path_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(external_data_layout_test)
+{
+    auto prog    = migraphx::parse_onnx("external_data_layout_test.onnx");
+    auto* mm     = prog.get_main_module();
+    auto outputs = std::prev(mm->end())->inputs();
+    EXPECT(outputs.size() == 3);
+    auto values = [](migraphx::instruction_ref ins) {
+        std::vector<float> result;
+        ins->get_literal().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        return result;
+    };
+    EXPECT(values(outputs[0]) == std::vector<float>{0, 1, 2, 3});
+    EXPECT(values(outputs[1]) == std::vector<float>{16, 17, 18, 19});
+    EXPECT(values(outputs[2]) == std::vector<float>{5, 6, 7});
+    // The aligned tensors view one mapping of the shared file, the unaligned one is copied
+    const char* data = outputs[0]->get_literal().data();
+    EXPECT(bool{outputs[1]->get_literal().data() == data + 64});
+    EXPECT(bool{outputs[2]->get_literal().data() != data + 20});
+}
+
+TEST_CASE(external_data_truncated_test)
+{
+    EXPECT(test::throws([&] { migraphx::parse_onnx("external_data_truncated_test.onnx"); }));
+}
+
+TEST_CASE(external_data_offset_test)
+{
+    EXPECT(test::throws([&] { migraphx::parse_onnx("external_data_offset_test.onnx"); }));
+}
+
 TEST_CASE(eyelike_default_test)
 {
     migraphx::program p;
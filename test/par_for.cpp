@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/par_for.hpp>
+#include <migraphx/par_dfor.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <test.hpp>
+
+TEST_CASE(par_for_all_elements)
+{
+    std::vector<std::size_t> v(1000, 0);
+    migraphx::par_for(v.size(), [&](auto i) { v[i] += i; });
+    std::vector<std::size_t> expected(v.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(v == expected);
+}
+
+TEST_CASE(par_for_tid_in_range)
+{
+    const std::size_t n = 4096;
+    std::vector<std::size_t> tids(n);
+    migraphx::par_for(n, 1, [&](auto i, auto tid) { tids[i] = tid; });
+    auto pool_size = migraphx::get_thread_pool().size();
+    EXPECT(std::all_of(tids.begin(), tids.end(), [&](auto tid) { return tid < pool_size; }));
+}
+
+TEST_CASE(par_for_nested)
+{
+    std::atomic<std::size_t> count{0};
+    migraphx::par_for(64, 1, [&](auto) { migraphx::par_for(64, 1, [&](auto) { count++; }); });
+    EXPECT(count.load() == 64 * 64);
+}
+
+TEST_CASE(par_for_chunks_all_elements)
+{
+    std::vector<int> v(1003, 0);
+    migraphx::par_for_chunks(v.size(), 1, [&](std::size_t start, std::size_t last) {
+        EXPECT(start < last);
+        for(auto i = start; i < last; i++)
+            v[i]++;
+    });
+    EXPECT(std::all_of(v.begin(), v.end(), [](auto x) { return x == 1; }));
+}
+
+TEST_CASE(par_for_exception)
+{
+    EXPECT(test::throws<std::runtime_error>([] {
+        migraphx::par_for(1000, 1, [&](auto i) {
+            if(i == 500)
+                throw std::runtime_error("par_for");
+        });
+    }));
+}
+
+TEST_CASE(par_dfor_all_elements)
+{
+    std::vector<int> v(4 * 5 * 6, 0);
+    migraphx::par_dfor(std::size_t{4}, std::size_t{5}, std::size_t{6})(
+        [&](std::size_t i, std::size_t j, std::size_t k) { v[i * 30 + j * 6 + k]++; });
+    EXPECT(std::all_of(v.begin(), v.end(), [](auto x) { return x == 1; }));
+}
+
+TEST_CASE(thread_pool_parallel_for)
+{
+    migraphx::thread_pool pool{4};
+    EXPECT(pool.size() == 4);
+    std::vector<int> v(1003, 0);
+    std::atomic<std::size_t> max_tid{0};
+    pool.parallel_for(v.size(), 4, 10, [&](std::size_t start, std::size_t last, std::size_t tid) {
+        std::size_t prev = max_tid;
+        while(prev < tid and not max_tid.compare_exchange_weak(prev, tid)) {}
+        for(auto i = start; i < last; i++)
+            v[i]++;
+    });
+    EXPECT(max_tid.load() < 4);
+    EXPECT(std::all_of(v.begin(), v.end(), [](auto x) { return x == 1; }));
+    auto stats = pool.get_stats();
+    EXPECT(stats.regions == 1);
+    EXPECT(stats.chunks == 101);
+    pool.reset_stats();
+    EXPECT(pool.get_stats().chunks == 0);
+}
+
+TEST_CASE(thread_pool_submit)
+{
+    std::atomic<int> count{0};
+    {
+        migraphx::thread_pool pool{2};
+        for(int i = 0; i < 100; i++)
+            pool.submit([&] { count++; });
+    }
+    EXPECT(count.load() == 100);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
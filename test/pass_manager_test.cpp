@@ -0,0 +1,134 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/propagate_constant.hpp>
+#include <migraphx/simplify_algebra.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <mutex>
+#include <unordered_set>
+
+#include <test.hpp>
+
+// These tests are also run with MIGRAPHX_PARALLEL_PASSES enabled, where module local passes are
+// applied to the independent submodules in parallel
+
+// Records that every module is visited after its submodules
+struct check_order
+{
+    struct state
+    {
+        std::mutex mutex;
+        std::unordered_set<std::string> visited;
+        bool ok = true;
+    };
+    std::shared_ptr<state> s = std::make_shared<state>();
+
+    std::string name() const { return "check_order"; }
+    bool is_module_local() const { return true; }
+    void apply(migraphx::module& m) const
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        for(const auto* sm : m.get_sub_modules(true))
+            s->ok = s->ok and migraphx::contains(s->visited, sm->name());
+        s->visited.insert(m.name());
+    }
+};
+
+// Add a module that computes x + (1 + 2) * 2 from literals only
+static migraphx::module_ref create_leaf(migraphx::program& p, const std::string& name)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto* m = p.create_module(name);
+    auto x  = m->add_literal(migraphx::generate_literal(s, 0));
+    auto l1 = m->add_literal(migraphx::literal{s, std::vector<float>(s.elements(), 1)});
+    auto l2 = m->add_literal(migraphx::literal{s, std::vector<float>(s.elements(), 2)});
+    auto a  = m->add_instruction(migraphx::make_op("add"), l1, l2);
+    auto b  = m->add_instruction(migraphx::make_op("mul"), a, l2);
+    m->add_return({m->add_instruction(migraphx::make_op("add"), x, b)});
+    return m;
+}
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s_cond{migraphx::shape::bool_type, {1}};
+    auto cond = mm->add_parameter("cond", s_cond);
+
+    auto* then_mod = p.create_module("then_mod");
+    auto* leaf1    = create_leaf(p, "leaf1");
+    auto* leaf2    = create_leaf(p, "leaf2");
+    auto r1 = then_mod->add_instruction(migraphx::make_op("if"), {cond}, {leaf1, leaf2});
+    then_mod->add_return({then_mod->add_instruction(
+        migraphx::make_op("get_tuple_elem", {{"index", 0}}), r1)});
+
+    auto* else_mod = p.create_module("else_mod");
+    auto* leaf3    = create_leaf(p, "leaf3");
+    auto* leaf4    = create_leaf(p, "leaf4");
+    auto r2 = else_mod->add_instruction(migraphx::make_op("if"), {cond}, {leaf3, leaf4});
+    else_mod->add_return({else_mod->add_instruction(
+        migraphx::make_op("get_tuple_elem", {{"index", 0}}), r2)});
+
+    auto ret = mm->add_instruction(migraphx::make_op("if"), {cond}, {then_mod, else_mod});
+    mm->add_return({mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), ret)});
+    return p;
+}
+
+TEST_CASE(module_local_passes)
+{
+    std::vector<migraphx::pass> passes = {migraphx::simplify_algebra{},
+                                          migraphx::propagate_constant{},
+                                          migraphx::dead_code_elimination{}};
+    auto p1 = create_program();
+    migraphx::run_passes(p1, passes);
+
+    // Apply the passes to one module at a time, with the submodules first
+    auto p2 = create_program();
+    for(const auto& name : {"leaf1", "leaf2", "then_mod", "leaf3", "leaf4", "else_mod", "main"})
+        migraphx::run_passes(*p2.get_module(name), passes);
+
+    EXPECT(p1.sort() == p2.sort());
+    auto mods = p1.get_modules();
+    EXPECT(std::all_of(mods.begin(), mods.end(), [](const auto* m) {
+        return std::none_of(m->begin(), m->end(), [](const auto& ins) {
+            return migraphx::contains({"add", "mul"}, ins.name());
+        });
+    }));
+}
+
+TEST_CASE(module_local_pass_order)
+{
+    check_order c;
+    auto p = create_program();
+    migraphx::run_passes(p, {c});
+    EXPECT(c.s->ok);
+    EXPECT(c.s->visited.size() == p.get_modules().size());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
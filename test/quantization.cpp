@@ -960,6 +960,56 @@ TEST_CASE(conv_half)
     EXPECT(p == qp);
 }
 
+TEST_CASE(conv_per_channel_weights)
+{
+    // The first output channel is much smaller than the second, so a single weight scale would
+    // round it to zero
+    auto create_program = [] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto input =
+            mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, {1, 2, 2, 2}});
+        migraphx::shape sw{migraphx::shape::float_type, {2, 2, 1, 1}};
+        auto weights = mm->add_literal(migraphx::literal{sw, {0.01f, -0.02f, 3.0f, -4.0f}});
+        auto r       = mm->add_instruction(migraphx::make_op("convolution"), input, weights);
+        mm->add_return({r});
+
+        return p;
+    };
+
+    auto run_prog = [](migraphx::program p) {
+        p.compile(migraphx::make_target("ref"));
+        std::vector<float> x = {0.5f, -1.0f, 0.25f, 1.0f, -0.5f, 0.75f, 1.0f, -0.25f};
+        migraphx::parameter_map m;
+        m["x"] = migraphx::argument{migraphx::shape{migraphx::shape::float_type, {1, 2, 2, 2}},
+                                    x.data()};
+        std::vector<float> result;
+        p.eval(m).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        return result;
+    };
+
+    auto p = create_program();
+    const std::vector<std::pair<float, float>> quant_params{{127.0f, 0.0f}, {127.0f / 4, 0.0f}};
+    migraphx::calibration_options options;
+    options.per_channel_weights = true;
+    migraphx::quantize_int8(p, quant_params, {"convolution"}, options);
+    EXPECT(std::any_of(p.get_main_module()->begin(),
+                       p.get_main_module()->end(),
+                       [](const auto& ins) { return ins.name() == "quant_convolution"; }));
+
+    auto ref_result   = run_prog(create_program());
+    auto quant_result = run_prog(p);
+    EXPECT(ref_result.size() == quant_result.size());
+    for(std::size_t i = 0; i < ref_result.size(); i++)
+        EXPECT(std::abs(quant_result[i] - ref_result[i]) <= 0.02f * std::abs(ref_result[i]));
+
+    // Per-channel weights are off by default, so the first channel loses its precision
+    auto p2 = create_program();
+    migraphx::quantize_int8(p2, quant_params, {"convolution"});
+    auto scalar_result = run_prog(p2);
+    EXPECT(std::abs(scalar_result[0] - ref_result[0]) > 0.02f * std::abs(ref_result[0]));
+}
+
 template <class T>
 auto get_hash(const T& x)
 {
@@ -21,6 +21,8 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <migraphx/convolution.hpp>
+#include <migraphx/generate.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/make_op.hpp>
@@ -740,3 +742,115 @@ TEST_CASE(conv3d_test)
     result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
     EXPECT(migraphx::verify::verify_range(results_vector, s));
 }
+
+template <class T>
+void verify_direct_convolution(migraphx::shape::type_t out_type,
+                               migraphx::shape::type_t in_type,
+                               std::vector<std::size_t> in_lens,
+                               std::vector<std::size_t> w_lens,
+                               std::vector<std::size_t> padding,
+                               std::vector<std::size_t> stride,
+                               int group)
+{
+    migraphx::shape in_shape{in_type, in_lens};
+    migraphx::shape w_shape{in_type, w_lens};
+    auto input   = migraphx::generate_argument(in_shape, 1);
+    auto weights = migraphx::generate_argument(w_shape, 2);
+    std::vector<std::size_t> dilation(stride.size(), 1);
+    auto op = migraphx::make_op(
+        "convolution",
+        {{"padding", padding}, {"stride", stride}, {"dilation", dilation}, {"group", group}});
+    migraphx::shape out_shape{out_type, op.compute_shape({in_shape, w_shape}).lens()};
+    migraphx::argument expected{out_shape};
+    migraphx::argument result{out_shape};
+    expected.visit([&](auto ev) {
+        result.visit([&](auto rv) {
+            visit_all(input, weights)([&](auto iv, auto wv) {
+                migraphx::convolution_reference(ev, iv, wv, padding, stride, group);
+                migraphx::direct_convolution(rv, iv, wv, padding, stride, group);
+            });
+        });
+    });
+    std::vector<T> ev;
+    std::vector<T> rv;
+    expected.visit([&](auto v) { ev.assign(v.begin(), v.end()); });
+    result.visit([&](auto v) { rv.assign(v.begin(), v.end()); });
+    EXPECT(migraphx::verify::verify_range(rv, ev));
+}
+
+TEST_CASE(direct_conv1d_test)
+{
+    verify_direct_convolution<float>(migraphx::shape::float_type,
+                                     migraphx::shape::float_type,
+                                     {2, 3, 17},
+                                     {4, 3, 3},
+                                     {1},
+                                     {2},
+                                     1);
+}
+
+TEST_CASE(direct_conv2d_test)
+{
+    verify_direct_convolution<float>(migraphx::shape::float_type,
+                                     migraphx::shape::float_type,
+                                     {2, 3, 9, 11},
+                                     {5, 3, 3, 3},
+                                     {1, 2},
+                                     {1, 1},
+                                     1);
+}
+
+TEST_CASE(direct_conv2d_stride_test)
+{
+    verify_direct_convolution<float>(migraphx::shape::float_type,
+                                     migraphx::shape::float_type,
+                                     {1, 4, 10, 13},
+                                     {2, 4, 5, 4},
+                                     {2, 1},
+                                     {3, 2},
+                                     1);
+}
+
+TEST_CASE(direct_conv3d_test)
+{
+    verify_direct_convolution<float>(migraphx::shape::float_type,
+                                     migraphx::shape::float_type,
+                                     {1, 2, 5, 6, 7},
+                                     {3, 2, 3, 2, 3},
+                                     {1, 0, 1},
+                                     {1, 2, 1},
+                                     1);
+}
+
+TEST_CASE(direct_conv_group_test)
+{
+    verify_direct_convolution<float>(migraphx::shape::float_type,
+                                     migraphx::shape::float_type,
+                                     {2, 6, 7, 7},
+                                     {4, 3, 3, 3},
+                                     {1, 1},
+                                     {1, 1},
+                                     2);
+}
+
+TEST_CASE(direct_conv_depthwise_test)
+{
+    verify_direct_convolution<float>(migraphx::shape::float_type,
+                                     migraphx::shape::float_type,
+                                     {1, 8, 9, 9},
+                                     {8, 1, 3, 3},
+                                     {1, 1},
+                                     {2, 2},
+                                     8);
+}
+
+TEST_CASE(direct_conv_int8_test)
+{
+    verify_direct_convolution<int32_t>(migraphx::shape::int32_type,
+                                       migraphx::shape::int8_type,
+                                       {2, 3, 6, 6},
+                                       {4, 3, 3, 3},
+                                       {1, 1},
+                                       {1, 1},
+                                       1);
+}
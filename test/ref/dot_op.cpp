@@ -1718,3 +1718,44 @@ TEST_CASE(quant_dot_3args_batch_2)
     result.visit([&](auto output) { m.assign(output.begin(), output.end()); });
     EXPECT(migraphx::verify::verify_range(m, gold));
 }
+
+TEST_CASE(dot_batch_broadcast_odd_sizes)
+{
+    // Sizes that are not multiples of the gemm micro-kernel tile
+    migraphx::program p;
+
+    auto* mm = p.get_main_module();
+    migraphx::shape a_shape{migraphx::shape::float_type, {3, 7, 13}};
+    migraphx::shape b_shape{migraphx::shape::float_type, {13, 11}};
+    std::vector<float> a(a_shape.elements());
+    std::vector<float> b(b_shape.elements());
+    std::iota(a.begin(), a.end(), -20.0f);
+    std::iota(b.begin(), b.end(), -50.0f);
+
+    auto al = mm->add_literal(migraphx::literal{a_shape, a});
+    auto bl = mm->add_literal(migraphx::literal{b_shape, b});
+    auto bb =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {3, 13, 11}}}), bl);
+    mm->add_instruction(migraphx::make_op("dot"), al, bb);
+
+    std::vector<float> gold(3 * 7 * 11);
+    for(std::size_t n = 0; n < 3; n++)
+    {
+        for(std::size_t i = 0; i < 7; i++)
+        {
+            for(std::size_t j = 0; j < 11; j++)
+            {
+                float sum = 0;
+                for(std::size_t k = 0; k < 13; k++)
+                    sum += a[n * 7 * 13 + i * 13 + k] * b[k * 11 + j];
+                gold[n * 7 * 11 + i * 11 + j] = sum;
+            }
+        }
+    }
+
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> m;
+    result.visit([&](auto output) { m.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify::verify_range(m, gold));
+}
@@ -21,14 +21,18 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <migraphx/env.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/literal.hpp>
+#include <migraphx/load_save.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/verify.hpp>
 
 #include <test.hpp>
+#include <algorithm>
+#include <numeric>
 
 TEST_CASE(pointwise_test)
 {
@@ -49,3 +53,77 @@ TEST_CASE(pointwise_test)
     std::vector<float> gold = {0, 2, 4};
     EXPECT(migraphx::verify::verify_range(results_vector, gold));
 }
+
+TEST_CASE(pointwise_large_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 1024}};
+    std::vector<float> data1(s.elements());
+    std::vector<float> data2(s.elements());
+    std::iota(data1.begin(), data1.end(), -2048);
+    std::iota(data2.begin(), data2.end(), 0);
+    auto l1  = mm->add_literal(migraphx::literal{s, data1});
+    auto l2  = mm->add_literal(migraphx::literal{s, data2});
+    auto* pm = p.create_module("pointwise");
+    auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+    auto add = pm->add_instruction(migraphx::make_op("add"), x1, x2);
+    pm->add_instruction(migraphx::make_op("relu"), add);
+    mm->add_instruction(migraphx::make_op("pointwise"), {l1, l2}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(s.elements());
+    std::transform(data1.begin(), data1.end(), data2.begin(), gold.begin(), [](auto x, auto y) {
+        return std::max(0.0f, x + y);
+    });
+    EXPECT(migraphx::verify::verify_range(results_vector, gold));
+}
+
+TEST_CASE(pointwise_params_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 1024}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto* pm = p.create_module("pointwise");
+    auto x1  = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto x2  = pm->add_parameter("x2", {migraphx::shape::float_type});
+    auto mul = pm->add_instruction(migraphx::make_op("mul"), x1, x2);
+    pm->add_instruction(migraphx::make_op("add"), mul, x1);
+    mm->add_instruction(migraphx::make_op("pointwise"), {x, y}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    // The pointwise module is only compiled for the host when MIGRAPHX_ENABLE_HOST_JIT is set
+    auto lowered = std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.name() == "ref::pointwise";
+    });
+    EXPECT(lowered == migraphx::enabled("MIGRAPHX_ENABLE_HOST_JIT"));
+
+    std::vector<float> data1(s.elements());
+    std::vector<float> data2(s.elements());
+    std::iota(data1.begin(), data1.end(), -2048);
+    std::iota(data2.begin(), data2.end(), 1);
+    std::vector<float> gold(s.elements());
+    std::transform(data1.begin(), data1.end(), data2.begin(), gold.begin(), [](auto a, auto b) {
+        return a * b + a;
+    });
+    auto run = [&](migraphx::program& prog) {
+        migraphx::parameter_map m;
+        m["x"]      = migraphx::argument{s, data1.data()};
+        m["y"]      = migraphx::argument{s, data2.data()};
+        auto result = prog.eval(m).back();
+        std::vector<float> results_vector;
+        result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+        return results_vector;
+    };
+    EXPECT(migraphx::verify::verify_range(run(p), gold));
+
+    // The host kernel is not saved, so it is compiled again when the program is loaded
+    migraphx::file_options options;
+    options.format = "json";
+    auto loaded    = migraphx::load_buffer(migraphx::save_buffer(p, options), options);
+    EXPECT(migraphx::verify::verify_range(run(loaded), gold));
+}
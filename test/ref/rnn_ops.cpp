@@ -30,6 +30,10 @@
 #include <migraphx/verify.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/rewrite_rnn.hpp>
+#include <migraphx/dead_code_elimination.hpp>
 
 #include <migraphx/quantization.hpp>
 #include <migraphx/serialize.hpp>
@@ -4988,3 +4992,98 @@ TEST_CASE(lstm_fp16)
         0.135643,  -0.0566208, 0.142701,   0.0342236,   -0.198664,  0.0702607};
     EXPECT(migraphx::verify::verify_range(hs_data, hs_data_gold, 5e4));
 }
+
+static migraphx::program
+create_rnn_program(const std::string& cell, migraphx::op::rnn_direction dirct, int lbr = 0)
+{
+    std::size_t batch_size  = 3;
+    std::size_t seq_len     = 4;
+    std::size_t hidden_size = 5;
+    std::size_t input_size  = 2;
+    std::size_t num_dirct   = (dirct == migraphx::op::rnn_direction::bidirectional) ? 2 : 1;
+    std::size_t num_gates   = 1;
+    if(cell == "gru")
+        num_gates = 3;
+    else if(cell == "lstm")
+        num_gates = 4;
+    migraphx::shape in_shape{migraphx::shape::float_type, {seq_len, batch_size, input_size}};
+    migraphx::shape w_shape{migraphx::shape::float_type,
+                            {num_dirct, num_gates * hidden_size, input_size}};
+    migraphx::shape r_shape{migraphx::shape::float_type,
+                            {num_dirct, num_gates * hidden_size, hidden_size}};
+    migraphx::shape b_shape{migraphx::shape::float_type, {num_dirct, 2 * num_gates * hidden_size}};
+    migraphx::shape sl_shape{migraphx::shape::int32_type, {batch_size}};
+    migraphx::shape ih_shape{migraphx::shape::float_type, {num_dirct, batch_size, hidden_size}};
+    migraphx::shape pph_shape{migraphx::shape::float_type, {num_dirct, 3 * hidden_size}};
+
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto seq  = mm->add_parameter("seq", in_shape);
+    auto w    = mm->add_literal(migraphx::generate_literal(w_shape, 1));
+    auto r    = mm->add_literal(migraphx::generate_literal(r_shape, 2));
+    auto bias = mm->add_literal(migraphx::generate_literal(b_shape, 3));
+    auto sl   = mm->add_literal(migraphx::literal{sl_shape, {4, 2, 3}});
+    auto ih   = mm->add_literal(migraphx::generate_literal(ih_shape, 4));
+    std::vector<migraphx::instruction_ref> args{seq, w, r, bias, sl, ih};
+    migraphx::value v = {{"hidden_size", hidden_size}, {"direction", migraphx::to_value(dirct)}};
+    if(cell == "gru")
+        v["linear_before_reset"] = lbr;
+    if(cell == "lstm")
+    {
+        args.push_back(mm->add_literal(migraphx::generate_literal(ih_shape, 5)));
+        args.push_back(mm->add_literal(migraphx::generate_literal(pph_shape, 6)));
+    }
+    auto hs = mm->add_instruction(migraphx::make_op(cell, v), args);
+    std::vector<migraphx::instruction_ref> outputs{
+        hs, mm->add_instruction(migraphx::make_op("rnn_last_hs_output"), hs)};
+    if(cell == "lstm")
+        outputs.push_back(mm->add_instruction(migraphx::make_op("rnn_last_cell_output"), hs));
+    mm->add_return(outputs);
+    return p;
+}
+
+static std::vector<migraphx::argument> run_rnn_program(migraphx::program p, bool sequence)
+{
+    migraphx::run_passes(p, {migraphx::rewrite_rnn{sequence}, migraphx::dead_code_elimination{}});
+    p.compile(migraphx::make_target("ref"));
+    migraphx::parameter_map m;
+    m["seq"] = migraphx::generate_argument(p.get_parameter_shape("seq"), 7);
+    return p.eval(m);
+}
+
+TEST_CASE(rnn_sequence_single_op)
+{
+    auto p = create_rnn_program("lstm", migraphx::op::rnn_direction::bidirectional);
+    migraphx::run_passes(p, {migraphx::rewrite_rnn{true}, migraphx::dead_code_elimination{}});
+    const auto* mm = p.get_main_module();
+    EXPECT(std::count_if(mm->begin(), mm->end(), [](const auto& ins) {
+               return ins.name() == "rnn_sequence";
+           }) == 1);
+    EXPECT(std::none_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "dot"; }));
+}
+
+TEST_CASE(rnn_sequence_matches_unrolled)
+{
+    for(auto dirct : {migraphx::op::rnn_direction::forward,
+                      migraphx::op::rnn_direction::reverse,
+                      migraphx::op::rnn_direction::bidirectional})
+    {
+        for(auto [cell, lbr] : std::vector<std::pair<std::string, int>>{
+                {"rnn", 0}, {"gru", 0}, {"gru", 1}, {"lstm", 0}})
+        {
+            auto p        = create_rnn_program(cell, dirct, lbr);
+            auto unrolled = run_rnn_program(p, false);
+            auto fused    = run_rnn_program(p, true);
+            EXPECT(unrolled.size() == fused.size());
+            for(std::size_t i = 0; i < unrolled.size(); i++)
+            {
+                std::vector<float> unrolled_data;
+                std::vector<float> fused_data;
+                unrolled[i].visit([&](auto x) { unrolled_data.assign(x.begin(), x.end()); });
+                fused[i].visit([&](auto x) { fused_data.assign(x.begin(), x.end()); });
+                EXPECT(migraphx::verify::verify_range(fused_data, unrolled_data));
+            }
+        }
+    }
+}
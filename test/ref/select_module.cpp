@@ -22,13 +22,16 @@
  * THE SOFTWARE.
  */
 #include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/op/select_module.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/verify.hpp>
 
 #include <test.hpp>
+#include <numeric>
 
 TEST_CASE(select_module_add_test)
 {
@@ -211,3 +214,156 @@ TEST_CASE(select_module_not_found_error)
     params["data"] = migraphx::argument(input_fixed_shape, input_data.data());
     EXPECT(test::throws([&] { std::ignore = p.eval(params).back(); }));
 }
+
+TEST_CASE(select_module_repeated_dispatch_test)
+{
+    migraphx::program p;
+    auto create_submodule = [&](std::size_t batch_size, const std::string& module_name) {
+        auto* submod = p.create_module(module_name);
+        migraphx::shape sm_shape{migraphx::shape::float_type, {batch_size, 4}};
+        auto sm_input = submod->add_parameter("data", sm_shape);
+        auto neg_ins  = submod->add_instruction(migraphx::make_op("neg"), sm_input);
+        submod->add_return({neg_ins});
+        return submod;
+    };
+    std::vector<migraphx::module_ref> submods;
+    for(std::size_t batch = 1; batch <= 8; batch++)
+        submods.push_back(create_submodule(batch, "batch_" + std::to_string(batch)));
+
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 8}, {4, 4}}};
+    auto input               = mm->add_parameter("data", s);
+    std::vector<migraphx::shape> sub_shapes = {
+        migraphx::shape{migraphx::shape::float_type, {{1, 8}, {4, 4}}}};
+    migraphx::shape out_attr = migraphx::shape{sub_shapes};
+    auto sm_ins              = mm->add_instruction(
+        migraphx::make_op("select_module", {{"output_dyn_shapes", migraphx::to_value(out_attr)}}),
+        {input},
+        submods);
+    auto ret = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), sm_ins);
+    mm->add_return({ret});
+    p.compile(migraphx::make_target("ref"));
+
+    for(std::size_t batch : {3, 1, 8, 2, 3})
+    {
+        std::vector<float> input_data(batch * 4);
+        std::iota(input_data.begin(), input_data.end(), 1);
+        migraphx::parameter_map params;
+        params["data"] = migraphx::argument({migraphx::shape::float_type, {batch, 4}},
+                                            input_data.data());
+        auto result = p.eval(params).back();
+        EXPECT(result.get_shape().lens() == std::vector<std::size_t>{batch, 4});
+        std::vector<float> results_vector;
+        result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+        std::vector<float> gold(input_data.size());
+        std::transform(
+            input_data.begin(), input_data.end(), gold.begin(), [](auto x) { return -x; });
+        EXPECT(migraphx::verify::verify_range(results_vector, gold));
+    }
+}
+
+TEST_CASE(select_module_submodule_changed_test)
+{
+    migraphx::program p;
+    auto create_submodule = [&](std::size_t batch_size, const std::string& module_name) {
+        auto* submod = p.create_module(module_name);
+        migraphx::shape sm_shape{migraphx::shape::float_type, {batch_size, 4}};
+        auto sm_input = submod->add_parameter("data", sm_shape);
+        auto neg_ins  = submod->add_instruction(migraphx::make_op("neg"), sm_input);
+        submod->add_return({neg_ins});
+        return submod;
+    };
+    auto* batch1 = create_submodule(1, "batch_1");
+    auto* batch2 = create_submodule(2, "batch_2");
+
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 3}, {4, 4}}};
+    auto input                              = mm->add_parameter("data", s);
+    std::vector<migraphx::shape> sub_shapes = {
+        migraphx::shape{migraphx::shape::float_type, {{1, 3}, {4, 4}}}};
+    migraphx::shape out_attr = migraphx::shape{sub_shapes};
+    auto sm_ins              = mm->add_instruction(
+        migraphx::make_op("select_module", {{"output_dyn_shapes", migraphx::to_value(out_attr)}}),
+        {input},
+        {batch1, batch2});
+    auto ret = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), sm_ins);
+    mm->add_return({ret});
+    p.compile(migraphx::make_target("ref"));
+
+    // Rebuild batch_2 for a batch of 3 after finalize made the dispatch table
+    std::vector<migraphx::instruction_ref> old_ins;
+    for(auto ins : migraphx::iterator_for(*batch2))
+    {
+        if(ins->name() != "@return")
+            old_ins.push_back(ins);
+    }
+    auto x_param = batch2->add_parameter("x", {migraphx::shape::float_type, {3, 4}});
+    auto neg     = batch2->insert_instruction(
+        std::prev(batch2->end()), migraphx::make_op("neg"), x_param);
+    batch2->replace_return({neg});
+    std::for_each(old_ins.rbegin(), old_ins.rend(), [&](auto ins) {
+        batch2->remove_instruction(ins);
+    });
+
+    std::vector<float> input_data(12);
+    std::iota(input_data.begin(), input_data.end(), 1);
+    migraphx::parameter_map params;
+    params["data"] = migraphx::argument({migraphx::shape::float_type, {3, 4}}, input_data.data());
+    auto result    = p.eval(params).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(input_data.size());
+    std::transform(input_data.begin(), input_data.end(), gold.begin(), [](auto x) { return -x; });
+    EXPECT(migraphx::verify::verify_range(results_vector, gold));
+}
+
+TEST_CASE(select_module_copied_program_test)
+{
+    auto p1               = std::make_unique<migraphx::program>();
+    auto create_submodule = [&](std::size_t batch_size, const std::string& module_name) {
+        auto* submod = p1->create_module(module_name);
+        migraphx::shape sm_shape{migraphx::shape::float_type, {batch_size, 4}};
+        auto sm_input = submod->add_parameter("data", sm_shape);
+        auto neg_ins  = submod->add_instruction(migraphx::make_op("neg"), sm_input);
+        submod->add_return({neg_ins});
+        return submod;
+    };
+    auto* batch1 = create_submodule(1, "batch_1");
+    auto* batch2 = create_submodule(2, "batch_2");
+
+    auto* mm = p1->get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 2}, {4, 4}}};
+    auto input                              = mm->add_parameter("data", s);
+    std::vector<migraphx::shape> sub_shapes = {
+        migraphx::shape{migraphx::shape::float_type, {{1, 2}, {4, 4}}}};
+    migraphx::shape out_attr = migraphx::shape{sub_shapes};
+    auto sm_ins              = mm->add_instruction(
+        migraphx::make_op("select_module", {{"output_dyn_shapes", migraphx::to_value(out_attr)}}),
+        {input},
+        {batch1, batch2});
+    auto ret = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), sm_ins);
+    mm->add_return({ret});
+    p1->compile(migraphx::make_target("ref"));
+
+    migraphx::program p2 = *p1;
+    p1.reset();
+    // The dispatch table of the copy refers to the copied submodules
+    auto* mm2 = p2.get_main_module();
+    auto it   = std::find_if(
+        mm2->begin(), mm2->end(), [](const auto& ins) { return ins.name() == "select_module"; });
+    EXPECT(bool{it != mm2->end()});
+    auto op = migraphx::any_cast<migraphx::op::select_module>(it->get_operator());
+    EXPECT(bool{op.table != nullptr});
+    EXPECT(op.table->is_current(it->module_inputs()));
+
+    std::vector<float> input_data(8);
+    std::iota(input_data.begin(), input_data.end(), 1);
+    migraphx::parameter_map params;
+    params["data"] = migraphx::argument({migraphx::shape::float_type, {2, 4}}, input_data.data());
+    auto result    = p2.eval(params).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(input_data.size());
+    std::transform(input_data.begin(), input_data.end(), gold.begin(), [](auto x) { return -x; });
+    EXPECT(migraphx::verify::verify_range(results_vector, gold));
+}
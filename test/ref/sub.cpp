@@ -46,6 +46,44 @@ TEST_CASE(sub_test)
     EXPECT(migraphx::verify::verify_range(results_vector, gold));
 }
 
+TEST_CASE(sub_broadcast_lhs_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape a_shape{migraphx::shape::float_type, {3}};
+    migraphx::shape b_shape{migraphx::shape::float_type, {2, 3, 2}};
+    std::vector<float> b_data{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    auto l1 = mm->add_literal(migraphx::literal{a_shape, {10, 20, 30}});
+    auto l2 = mm->add_literal(migraphx::literal{b_shape, b_data});
+    auto l3 = mm->add_instruction(
+        migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", b_shape.lens()}}), l1);
+    mm->add_instruction(migraphx::make_op("sub"), l3, l2);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector(12);
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold = {10, 9, 18, 17, 26, 25, 4, 3, 12, 11, 20, 19};
+    EXPECT(migraphx::verify::verify_range(results_vector, gold));
+}
+
+TEST_CASE(sub_scalar_rhs_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape a_shape{migraphx::shape::float_type, {2, 3}};
+    auto l1 = mm->add_literal(migraphx::literal{a_shape, {0, 1, 2, 3, 4, 5}});
+    auto l2 = mm->add_literal(migraphx::literal{migraphx::shape{migraphx::shape::float_type}, {1}});
+    auto l3 = mm->add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", a_shape.lens()}}), l2);
+    mm->add_instruction(migraphx::make_op("sub"), l1, l3);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector(6);
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold = {-1, 0, 1, 2, 3, 4};
+    EXPECT(migraphx::verify::verify_range(results_vector, gold));
+}
+
 TEST_CASE(sub_dyn_test)
 {
     migraphx::program p;
@@ -24,10 +24,15 @@
 #include <migraphx/program.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/instruction.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <numeric>
 
 migraphx::program create_program()
 {
@@ -49,6 +54,21 @@ TEST_CASE(as_value)
     EXPECT(p1.sort() == p2.sort());
 }
 
+TEST_CASE(previous_file_version)
+{
+    migraphx::program p1 = create_program();
+    auto v               = p1.to_value();
+    EXPECT(v.at("version").to<int>() == 7);
+    // Version 6 files have no shared or aligned literals and are still read
+    v["version"] = 6;
+    migraphx::program p2;
+    p2.from_value(v);
+    EXPECT(p1.sort() == p2.sort());
+    v["version"] = 5;
+    migraphx::program p3;
+    EXPECT(test::throws([&] { p3.from_value(v); }));
+}
+
 TEST_CASE(as_msgpack)
 {
     migraphx::file_options options;
@@ -79,6 +99,121 @@ TEST_CASE(as_file)
     EXPECT(p1.sort() == p2.sort());
 }
 
+TEST_CASE(as_mapped_file)
+{
+    std::string filename = "migraphx_program_mapped.mxr";
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {16, 64}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 1.0f);
+    auto x = mm->add_parameter("x", s);
+    auto l = mm->add_literal(migraphx::literal{s, data});
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), x, l)});
+    migraphx::save(p1, filename);
+
+    migraphx::file_options options;
+    options.mmap         = true;
+    migraphx::program p2 = migraphx::load(filename, options);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    // The literal data is used directly from the page aligned data in the file
+    auto* mm2 = p2.get_main_module();
+    EXPECT(std::all_of(mm2->begin(), mm2->end(), [](const auto& ins) {
+        if(ins.name() != "@literal")
+            return true;
+        return reinterpret_cast<std::uintptr_t>(ins.get_literal().data()) % 4096 == 0;
+    }));
+}
+
+migraphx::program create_shared_program(bool shared = true)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {16, 64}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 1.0f);
+    migraphx::literal l{s, data};
+    auto x  = mm->add_parameter("x", s);
+    auto l1 = mm->add_literal(l);
+    auto l2 = mm->add_literal(shared ? l.share(s) : migraphx::literal{s, data});
+    auto a1 = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    mm->add_return({mm->add_instruction(migraphx::make_op("mul"), a1, l2)});
+    return p;
+}
+
+static bool literals_shared(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    std::vector<migraphx::literal> lits;
+    for(const auto& ins : *mm)
+    {
+        if(ins.name() == "@literal")
+            lits.push_back(ins.get_literal());
+    }
+    return lits.size() == 2 and lits.front().shares_buffer(lits.back());
+}
+
+TEST_CASE(shared_literals)
+{
+    for(const std::string format : {"msgpack", "json"})
+    {
+        migraphx::file_options options;
+        options.format           = format;
+        migraphx::program p1     = create_shared_program();
+        std::vector<char> buffer = migraphx::save_buffer(p1, options);
+        migraphx::program p2     = migraphx::load_buffer(buffer, options);
+        EXPECT(p1.sort() == p2.sort());
+        EXPECT(literals_shared(p2));
+        // The data is only written once
+        std::vector<char> unshared = migraphx::save_buffer(create_shared_program(false), options);
+        EXPECT(buffer.size() < unshared.size());
+    }
+}
+
+TEST_CASE(shared_literals_mapped_file)
+{
+    std::string filename = "migraphx_program_shared.mxr";
+    migraphx::program p1 = create_shared_program();
+    migraphx::save(p1, filename);
+
+    migraphx::file_options options;
+    options.mmap         = true;
+    migraphx::program p2 = migraphx::load(filename, options);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(literals_shared(p2));
+}
+
+TEST_CASE(as_mapped_file_mid_size_literal)
+{
+    std::string filename = "migraphx_program_mapped_mid.mxr";
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    // Smaller than a page, but large enough to be used in place
+    migraphx::shape s{migraphx::shape::float_type, {100}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 1.0f);
+    auto x = mm->add_parameter("x", s);
+    auto l = mm->add_literal(migraphx::literal{s, data});
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), x, l)});
+    migraphx::save(p1, filename);
+
+    migraphx::file_options options;
+    options.mmap         = true;
+    migraphx::program p2 = migraphx::load(filename, options);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    auto* mm2 = p2.get_main_module();
+    EXPECT(std::all_of(mm2->begin(), mm2->end(), [](const auto& ins) {
+        if(ins.name() != "@literal")
+            return true;
+        return reinterpret_cast<std::uintptr_t>(ins.get_literal().data()) %
+                   migraphx::msgpack_min_alignment ==
+               0;
+    }));
+}
+
 TEST_CASE(compiled)
 {
     migraphx::program p1 = create_program();
@@ -23,6 +23,7 @@
  */
 
 #include <migraphx/shape.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/serialize.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/permutation.hpp>
@@ -1028,4 +1029,48 @@ TEST_CASE(from_4d_permutation)
     EXPECT(migraphx::find_permutation(out_shape) == permutation);
 }
 
+TEST_CASE(shape_index_transposed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 4, 5}, {1, 15, 3}};
+    migraphx::shape_index it{s, 17};
+    for(std::size_t i = 17; i < s.elements(); i++, ++it)
+    {
+        EXPECT(it.element() == i);
+        EXPECT(it.multi() == s.multi(i));
+        EXPECT(it.offset() == s.index(i));
+    }
+}
+
+TEST_CASE(shape_index_broadcasted)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}, {0, 1, 0}};
+    migraphx::shape_index it{s};
+    for(std::size_t i = 0; i < s.elements(); i++, ++it)
+        EXPECT(it.offset() == s.index(s.multi(i)));
+}
+
+TEST_CASE(shape_for_each_range)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    std::vector<std::size_t> visited;
+    migraphx::shape_for_each(s, 5, 19, [&](const auto& idx, std::size_t i) {
+        EXPECT(idx == s.multi(i));
+        visited.push_back(i);
+    });
+    std::vector<std::size_t> expected(14);
+    std::iota(expected.begin(), expected.end(), 5);
+    EXPECT(visited == expected);
+}
+
+TEST_CASE(par_shape_for_each_all_elements)
+{
+    migraphx::shape s{migraphx::shape::float_type, {7, 13, 11}};
+    std::vector<int> v(s.elements(), 0);
+    migraphx::par_shape_for_each(s, [&](const auto& idx, std::size_t i) {
+        if(s.index(idx) == i)
+            v[i]++;
+    });
+    EXPECT(std::all_of(v.begin(), v.end(), [](auto x) { return x == 1; }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
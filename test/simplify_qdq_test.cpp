@@ -178,6 +178,54 @@ TEST_CASE(dot)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(dot_per_channel)
+{
+    migraphx::shape sh1{migraphx::shape::float_type, {12, 16}};
+    migraphx::shape sh2{migraphx::shape::float_type, {16, 8}};
+    migraphx::shape ss{migraphx::shape::float_type, {8}};
+    std::vector<float> channel_scales = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f};
+    std::vector<float> out_scales;
+    std::transform(channel_scales.begin(),
+                   channel_scales.end(),
+                   std::back_inserter(out_scales),
+                   [](double x) { return 0.5 * x; });
+
+    migraphx::module m1;
+    {
+        auto t1      = m1.add_parameter("t1", sh1);
+        auto t2      = m1.add_parameter("t2", sh2);
+        auto scale   = m1.add_literal(0.5f);
+        auto w_scale = m1.add_literal(migraphx::literal{ss, channel_scales});
+        auto zero    = m1.add_literal(std::int8_t{0});
+
+        auto q1  = add_quantize_op(m1, "quantizelinear", t1, scale, zero);
+        auto d1  = add_quantize_op(m1, "dequantizelinear", q1, scale, zero);
+        auto q2  = add_quantize_op(m1, "quantizelinear", t2, w_scale, zero);
+        auto d2  = add_quantize_op(m1, "dequantizelinear", q2, w_scale, zero);
+        auto dot = m1.add_instruction(migraphx::make_op("dot"), d1, d2);
+        m1.add_return({dot});
+    }
+
+    migraphx::module m2;
+    {
+        auto t1      = m2.add_parameter("t1", sh1);
+        auto t2      = m2.add_parameter("t2", sh2);
+        auto scale   = m2.add_literal(0.5f);
+        auto w_scale = m2.add_literal(migraphx::literal{ss, channel_scales});
+        auto zero    = m2.add_literal(std::int8_t{0});
+        auto scale1  = m2.add_literal(migraphx::literal{ss, out_scales});
+
+        auto q1  = add_quantize_op(m2, "quantizelinear", t1, scale, zero);
+        auto q2  = add_quantize_op(m2, "quantizelinear", t2, w_scale, zero);
+        auto dot = m2.add_instruction(migraphx::make_op("quant_dot"), q1, q2);
+        auto d3  = add_quantize_op(m2, "dequantizelinear", dot, scale1);
+        m2.add_return({d3});
+    }
+
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(dot_non_zero_point)
 {
     migraphx::shape sh1{migraphx::shape::float_type, {1280, 1000}};
@@ -339,6 +387,62 @@ TEST_CASE(conv)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(conv_per_channel)
+{
+    migraphx::shape s4{migraphx::shape::int8_type, {4, 8, 1, 1}};
+    migraphx::shape s7{migraphx::shape::float_type, {1, 8, 3, 3}};
+    migraphx::shape ss{migraphx::shape::float_type, {4}};
+    std::vector<float> channel_scales = {0.1f, 0.2f, 0.3f, 0.4f};
+    std::vector<float> out_scales;
+    std::transform(channel_scales.begin(),
+                   channel_scales.end(),
+                   std::back_inserter(out_scales),
+                   [](double x) { return 0.5 * x; });
+    auto add_weight_dq = [&](migraphx::module& m,
+                             migraphx::instruction_ref weights,
+                             migraphx::instruction_ref scale,
+                             migraphx::instruction_ref zero) {
+        auto scale_b = m.add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 0}, {"out_lens", s4.lens()}}), scale);
+        auto zero_mb = m.add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", s4.lens()}}), zero);
+        return m.add_instruction(
+            migraphx::make_op("dequantizelinear"), weights, scale_b, zero_mb);
+    };
+
+    migraphx::module m1;
+    {
+        auto input   = m1.add_parameter("input", s7);
+        auto weights = m1.add_parameter("weights", s4);
+        auto scale   = m1.add_literal(0.5f);
+        auto w_scale = m1.add_literal(migraphx::literal{ss, channel_scales});
+        auto zero    = m1.add_literal(std::int8_t{0});
+
+        auto d1 = add_weight_dq(m1, weights, w_scale, zero);
+        auto q1 = add_quantize_op(m1, "quantizelinear", input, scale, zero);
+        auto d5 = add_quantize_op(m1, "dequantizelinear", q1, scale, zero);
+        auto c1 = m1.add_instruction(migraphx::make_op("convolution"), d5, d1);
+        m1.add_return({c1});
+    }
+
+    migraphx::module m2;
+    {
+        auto input   = m2.add_parameter("input", s7);
+        auto weights = m2.add_parameter("weights", s4);
+        auto scale   = m2.add_literal(0.5f);
+        auto zero    = m2.add_literal(std::int8_t{0});
+        auto scale1  = m2.add_literal(migraphx::literal{ss, out_scales});
+
+        auto q1 = add_quantize_op(m2, "quantizelinear", input, scale, zero);
+        auto c1 = m2.add_instruction(migraphx::make_op("quant_convolution"), q1, weights);
+        auto d6 = add_quantize_op(m2, "dequantizelinear", c1, scale1);
+        m2.add_return({d6});
+    }
+
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(conv_multi_scale)
 {
     migraphx::shape s4{migraphx::shape::int8_type, {1280, 320, 1, 1}};
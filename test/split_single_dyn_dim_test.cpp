@@ -28,7 +28,13 @@
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/serialize.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/env.hpp>
 #include <test.hpp>
+#include <numeric>
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_DYN_DIM_BUCKETS)
 
 void run_pass(migraphx::program& p)
 {
@@ -217,4 +223,146 @@ TEST_CASE(broadcast_match)
     EXPECT(p0 == p1);
 }
 
+migraphx::program make_dynamic_add(const migraphx::shape& s)
+{
+    migraphx::program p;
+    auto* mm   = p.get_main_module();
+    auto input = mm->add_parameter("data", s);
+    migraphx::shape lit_s{migraphx::shape{migraphx::shape::float_type, {1}}};
+    auto literal_ins   = mm->add_literal(migraphx::literal{lit_s, {6}});
+    auto broadcast_lit =
+        mm->add_instruction(migraphx::make_op("multibroadcast"), literal_ins, input);
+    auto add_ins       = mm->add_instruction(migraphx::make_op("add"), input, broadcast_lit);
+    mm->add_return({add_ins});
+    return p;
+}
+
+std::vector<std::string> select_module_inputs(const migraphx::program& p)
+{
+    auto* mm = p.get_main_module();
+    auto sm  = std::find_if(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "select_module"; });
+    std::vector<std::string> names;
+    std::transform(sm->module_inputs().begin(),
+                   sm->module_inputs().end(),
+                   std::back_inserter(names),
+                   [](auto* m) { return m->name(); });
+    return names;
+}
+
+TEST_CASE(bucket_powers_of_two)
+{
+    auto p = make_dynamic_add({migraphx::shape::float_type, {{3, 20}, {4, 4}}});
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    EXPECT(select_module_inputs(p) ==
+           std::vector<std::string>{"bucket_4", "bucket_8", "bucket_16", "bucket_20"});
+}
+
+TEST_CASE(bucket_optimals)
+{
+    auto p = make_dynamic_add({migraphx::shape::float_type, {{1, 10, {3, 6, 12}}, {4, 4}}});
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    EXPECT(select_module_inputs(p) ==
+           std::vector<std::string>{"bucket_3", "bucket_6", "bucket_10"});
+}
+
+TEST_CASE(bucket_fixed_output)
+{
+    // Reducing over the dynamic dimension can't be padded
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto input =
+        mm->add_parameter("data", migraphx::shape{migraphx::shape::float_type, {{1, 3}, {4, 4}}});
+    auto reduce = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {0}}}), input);
+    mm->add_return({reduce});
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    EXPECT(select_module_inputs(p) == std::vector<std::string>{"dim_1", "dim_2", "dim_3"});
+}
+
+migraphx::program make_dynamic_softmax(int64_t axis)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto input =
+        mm->add_parameter("data", migraphx::shape{migraphx::shape::float_type, {{1, 8}, {4, 4}}});
+    auto softmax = mm->add_instruction(migraphx::make_op("softmax", {{"axis", axis}}), input);
+    mm->add_return({softmax});
+    return p;
+}
+
+TEST_CASE(bucket_softmax_dyn_axis)
+{
+    // The padded elements would be part of the softmax
+    auto p = make_dynamic_softmax(0);
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    EXPECT(select_module_inputs(p).front() == "dim_1");
+}
+
+TEST_CASE(bucket_softmax_other_axis)
+{
+    auto p = make_dynamic_softmax(-1);
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    EXPECT(select_module_inputs(p) ==
+           std::vector<std::string>{"bucket_1", "bucket_2", "bucket_4", "bucket_8"});
+}
+
+void check_dynamic_add(migraphx::program& p, const std::vector<std::size_t>& lens)
+{
+    std::vector<float> input_data(std::accumulate(
+        lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>{}));
+    std::iota(input_data.begin(), input_data.end(), 0);
+    migraphx::parameter_map params;
+    params["data"] = migraphx::argument({migraphx::shape::float_type, lens}, input_data.data());
+    auto result    = p.eval(params).back();
+    EXPECT(result.get_shape().lens() == lens);
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(input_data.size());
+    std::transform(
+        input_data.begin(), input_data.end(), gold.begin(), [](auto x) { return x + 6; });
+    EXPECT(results_vector == gold);
+}
+
+TEST_CASE(bucket_eval)
+{
+    auto p = make_dynamic_add({migraphx::shape::float_type, {{1, 8}, {4, 4}}});
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    p.compile(migraphx::make_target("ref"));
+    for(std::size_t batch : {1, 3, 5, 8})
+        check_dynamic_add(p, {batch, 4});
+}
+
+TEST_CASE(bucket_eval_inner_axis)
+{
+    auto p = make_dynamic_add({migraphx::shape::float_type, {{2, 2}, {1, 8}, {3, 3}}});
+    migraphx::run_passes(
+        p, {migraphx::split_single_dyn_dim{true}, migraphx::dead_code_elimination{}});
+    p.compile(migraphx::make_target("ref"));
+    for(std::size_t len : {1, 3, 5, 8})
+        check_dynamic_add(p, {2, len, 3});
+}
+
+TEST_CASE(ref_bucket_option)
+{
+    auto p = make_dynamic_add({migraphx::shape::float_type, {{1, 8}, {4, 4}}});
+    p.compile(migraphx::make_target("ref"));
+    auto* mm = p.get_main_module();
+    bool split = std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "select_module"; });
+    EXPECT(split == migraphx::enabled(MIGRAPHX_ENABLE_DYN_DIM_BUCKETS{}));
+    if(split)
+    {
+        EXPECT(select_module_inputs(p) ==
+               std::vector<std::string>{"bucket_1", "bucket_2", "bucket_4", "bucket_8"});
+    }
+    for(std::size_t batch : {2, 3, 8})
+        check_dynamic_add(p, {batch, 4});
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -38,6 +38,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
+#include <migraphx/batch_queue.hpp>
 #include <algorithm>
 #include <cstdarg>
 namespace migraphx {
@@ -139,6 +140,20 @@ void set_exhaustive_tune_flag(compile_options& options, bool value)
     options.exhaustive_tune = value;
 }
 
+void set_max_batch(batch_queue_options& options, size_t value) { options.max_batch = value; }
+
+void set_timeout(batch_queue_options& options, size_t microseconds)
+{
+    options.timeout = std::chrono::microseconds{microseconds};
+}
+
+bool is_ready(const batch_result& result)
+{
+    return result.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+std::vector<argument> get_result(const batch_result& result) { return result.get(); }
+
 void set_file_format(file_options& options, const char* format) { options.format = format; }
 
 void set_default_dim_value(onnx_options& options, size_t value)
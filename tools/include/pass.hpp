@@ -53,6 +53,9 @@ struct pass
     void apply(module& m) const;
     /// Run the pass on the program
     void apply(program& p) const;
+    /// Whether the pass only reads and changes the module it is applied to, so it can be applied
+    /// to independent modules at the same time
+    bool is_module_local() const;
 };
 
 #else
@@ -79,13 +82,20 @@ void module_pass_manager_apply(const T& x, module_pass_manager& mpm)
     module_pass_manager_apply(rank<1>{}, x, mpm);
 }
 
+template <class T>
+bool pass_is_module_local(const T&)
+{
+    return false;
+}
+
 } // namespace detail
 
 <%
 interface('pass',
     virtual('name', returns='std::string', const=True),
     virtual('apply', returns='void', mpm='module_pass_manager &', const=True, default='migraphx::detail::module_pass_manager_apply'),
-    virtual('apply', returns='void', p='program &', const=True, default='migraphx::nop')
+    virtual('apply', returns='void', p='program &', const=True, default='migraphx::nop'),
+    virtual('is_module_local', returns='bool', const=True, default='migraphx::detail::pass_is_module_local')
 )
 %>
 